@@ -18,11 +18,14 @@
  * Date: June 2025
  */
 
+#define _GNU_SOURCE  // process_vm_readv/writev
+
 #include "multiarch_debugger.h"
 #include <sys/ptrace.h>
 #include <sys/wait.h>
 #include <sys/user.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
 #include <signal.h>
 #include <capstone/capstone.h>
 #include <keystone/keystone.h>
@@ -75,10 +78,268 @@ typedef struct {
 
 static debug_performance_t g_perf_stats;
 
+// ==================== Bulk Memory Access ====================
+//
+// PTRACE_PEEKDATA costs a syscall per 8 bytes; at 10M+ single-stepped
+// instructions the trace tooling spends nearly all its time in the
+// kernel. process_vm_readv pulls whole pages in one syscall, and a
+// small direct-mapped page cache serves repeated reads (instruction
+// fetch, operand decode) for free. The cache is flushed on every step
+// or write since the target may have modified its own memory.
+
+#define MEM_CACHE_PAGES     16
+#define MEM_CACHE_PAGE_SIZE 4096
+
+typedef struct {
+    uint64_t page_addr;     // Page-aligned target address
+    bool valid;
+    uint8_t data[MEM_CACHE_PAGE_SIZE];
+} mem_cache_page_t;
+
+static mem_cache_page_t mem_cache[MEM_CACHE_PAGES];
+static bool process_vm_unavailable = false;  // Yama/old kernel fallback
+
+static void memory_cache_invalidate(void) {
+    for (int i = 0; i < MEM_CACHE_PAGES; i++) {
+        mem_cache[i].valid = false;
+    }
+}
+
+// Word-by-word fallback when process_vm_readv is denied
+static int peek_fallback(uint64_t address, void *buffer, size_t size) {
+    uint8_t *out = buffer;
+    size_t done = 0;
+
+    while (done < size) {
+        errno = 0;
+        long data = ptrace(PTRACE_PEEKDATA, g_debugger.target_pid,
+                           (void*)(address + done), NULL);
+        if (errno != 0) {
+            return -errno;
+        }
+
+        size_t chunk = size - done < sizeof(long) ? size - done : sizeof(long);
+        memcpy(out + done, &data, chunk);
+        done += chunk;
+    }
+
+    return 0;
+}
+
+// Fill one cache slot with a full page from the target
+static mem_cache_page_t *memory_cache_fill(uint64_t page_addr) {
+    mem_cache_page_t *slot =
+        &mem_cache[(page_addr / MEM_CACHE_PAGE_SIZE) % MEM_CACHE_PAGES];
+
+    if (slot->valid && slot->page_addr == page_addr) {
+        return slot;
+    }
+
+    if (!process_vm_unavailable) {
+        struct iovec local = { .iov_base = slot->data,
+                               .iov_len = MEM_CACHE_PAGE_SIZE };
+        struct iovec remote = { .iov_base = (void*)page_addr,
+                                .iov_len = MEM_CACHE_PAGE_SIZE };
+
+        ssize_t n = process_vm_readv(g_debugger.target_pid,
+                                     &local, 1, &remote, 1, 0);
+        if (n == MEM_CACHE_PAGE_SIZE) {
+            slot->page_addr = page_addr;
+            slot->valid = true;
+            g_perf_stats.memory_accesses++;
+            return slot;
+        }
+        if (n < 0 && (errno == ENOSYS || errno == EPERM)) {
+            process_vm_unavailable = true;
+        }
+    }
+
+    if (peek_fallback(page_addr, slot->data, MEM_CACHE_PAGE_SIZE) != 0) {
+        return NULL;
+    }
+
+    slot->page_addr = page_addr;
+    slot->valid = true;
+    g_perf_stats.memory_accesses++;
+    return slot;
+}
+
+// Bulk read through the page cache; spans page boundaries
+int debugger_read_memory(uint64_t address, void *buffer, size_t size) {
+    uint8_t *out = buffer;
+    size_t done = 0;
+
+    while (done < size) {
+        uint64_t addr = address + done;
+        uint64_t page_addr = addr & ~(uint64_t)(MEM_CACHE_PAGE_SIZE - 1);
+        size_t offset = addr - page_addr;
+        size_t chunk = MEM_CACHE_PAGE_SIZE - offset;
+        if (chunk > size - done) {
+            chunk = size - done;
+        }
+
+        mem_cache_page_t *page = memory_cache_fill(page_addr);
+        if (!page) {
+            // Unmapped page in the middle of the range
+            return peek_fallback(addr, out + done, size - done);
+        }
+
+        memcpy(out + done, page->data + offset, chunk);
+        done += chunk;
+    }
+
+    return 0;
+}
+
+// Bulk write; goes around the cache and invalidates it
+int debugger_write_memory(uint64_t address, const void *buffer, size_t size) {
+    memory_cache_invalidate();
+
+    if (!process_vm_unavailable) {
+        struct iovec local = { .iov_base = (void*)buffer, .iov_len = size };
+        struct iovec remote = { .iov_base = (void*)address, .iov_len = size };
+
+        ssize_t n = process_vm_writev(g_debugger.target_pid,
+                                      &local, 1, &remote, 1, 0);
+        if (n == (ssize_t)size) {
+            g_perf_stats.memory_accesses++;
+            return 0;
+        }
+        // process_vm_writev honors page protections, so text pages
+        // need the ptrace path below
+    }
+
+    const uint8_t *in = buffer;
+    size_t done = 0;
+
+    while (done < size) {
+        long data;
+        size_t chunk = size - done < sizeof(long) ? size - done : sizeof(long);
+
+        if (chunk < sizeof(long)) {
+            // Partial word: read-modify-write
+            errno = 0;
+            data = ptrace(PTRACE_PEEKDATA, g_debugger.target_pid,
+                          (void*)(address + done), NULL);
+            if (errno != 0) {
+                return -errno;
+            }
+        }
+
+        memcpy(&data, in + done, chunk);
+
+        if (ptrace(PTRACE_POKEDATA, g_debugger.target_pid,
+                   (void*)(address + done), data) == -1) {
+            return -errno;
+        }
+        done += chunk;
+    }
+
+    g_perf_stats.memory_accesses++;
+    return 0;
+}
+
+// ==================== Breakpoint Hash Table ====================
+//
+// Resolving the breakpoint at a faulting PC by walking the linked
+// list is O(n) per stop; with hundreds of breakpoints and millions of
+// stops it dominates. Open addressing with linear probing keeps the
+// lookup to a couple of cache lines.
+
+#define BP_HASH_INITIAL 256     // Power of two
+#define BP_HASH_MAX_LOAD(cap) ((cap) - (cap) / 4)
+
+static breakpoint_t **bp_hash_table = NULL;
+static uint32_t bp_hash_capacity = 0;
+static uint32_t bp_hash_count = 0;
+
+static uint32_t bp_hash(uint64_t address) {
+    // Fibonacci hashing: breakpoint addresses share alignment and
+    // high bits, which multiplication mixes well
+    return (uint32_t)((address * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static int bp_hash_grow(void);
+
+static int bp_hash_insert(breakpoint_t *bp) {
+    if (bp_hash_count >= BP_HASH_MAX_LOAD(bp_hash_capacity)) {
+        if (bp_hash_grow() != 0) {
+            return -ENOMEM;
+        }
+    }
+
+    uint32_t mask = bp_hash_capacity - 1;
+    uint32_t idx = bp_hash(bp->address) & mask;
+
+    while (bp_hash_table[idx]) {
+        if (bp_hash_table[idx]->address == bp->address) {
+            bp_hash_table[idx] = bp;  // Re-armed breakpoint
+            return 0;
+        }
+        idx = (idx + 1) & mask;
+    }
+
+    bp_hash_table[idx] = bp;
+    bp_hash_count++;
+    return 0;
+}
+
+static int bp_hash_grow(void) {
+    uint32_t new_capacity = bp_hash_capacity ? bp_hash_capacity * 2
+                                             : BP_HASH_INITIAL;
+    breakpoint_t **new_table = calloc(new_capacity, sizeof(breakpoint_t*));
+    if (!new_table) {
+        return -ENOMEM;
+    }
+
+    breakpoint_t **old_table = bp_hash_table;
+    uint32_t old_capacity = bp_hash_capacity;
+
+    bp_hash_table = new_table;
+    bp_hash_capacity = new_capacity;
+    bp_hash_count = 0;
+
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old_table[i]) {
+            bp_hash_insert(old_table[i]);
+        }
+    }
+
+    free(old_table);
+    return 0;
+}
+
+// O(1) breakpoint resolution for the single-step path
+breakpoint_t *debugger_find_breakpoint(uint64_t address) {
+    if (bp_hash_count == 0) {
+        return NULL;
+    }
+
+    uint32_t mask = bp_hash_capacity - 1;
+    uint32_t idx = bp_hash(address) & mask;
+
+    while (bp_hash_table[idx]) {
+        if (bp_hash_table[idx]->address == address) {
+            return bp_hash_table[idx];
+        }
+        idx = (idx + 1) & mask;
+    }
+
+    return NULL;
+}
+
 // Initialize debugger for specific architecture
 int debugger_init(target_architecture_t arch) {
     memset(&g_debugger, 0, sizeof(debugger_context_t));
     memset(&g_perf_stats, 0, sizeof(debug_performance_t));
+
+    memory_cache_invalidate();
+    process_vm_unavailable = false;
+
+    free(bp_hash_table);
+    bp_hash_table = NULL;
+    bp_hash_capacity = 0;
+    bp_hash_count = 0;
     
     // Select architecture configuration
     switch (arch) {
@@ -188,11 +449,17 @@ int debugger_set_breakpoint(uint64_t address, breakpoint_type_t type) {
         return -errno;
     }
     
-    // Add to breakpoint list
+    // Add to breakpoint list and hash
     bp->next = g_debugger.breakpoints;
     g_debugger.breakpoints = bp;
     g_debugger.num_breakpoints++;
-    
+
+    // On allocation failure the breakpoint still fires; only the O(1)
+    // lookup is lost for it
+    bp_hash_insert(bp);
+
+    memory_cache_invalidate();  // We just patched target text
+
     return 0;
 }
 
@@ -282,15 +549,21 @@ int debugger_single_step_analysis(void) {
     
     // Get current instruction pointer
     uint64_t pc = debugger_get_pc();
-    
-    // Disassemble instruction at PC
+
+    // Resolve a software breakpoint at PC without walking the list
+    breakpoint_t *bp = debugger_find_breakpoint(pc);
+    if (bp && bp->enabled) {
+        bp->hit_count++;
+        g_perf_stats.breakpoints_hit++;
+    }
+
+    // Disassemble instruction at PC: one cached bulk read instead of
+    // two PTRACE_PEEKTEXT round trips
     uint8_t code[16];
-    for (int i = 0; i < 16; i += sizeof(long)) {
-        long data = ptrace(PTRACE_PEEKTEXT, g_debugger.target_pid, 
-                          (void*)(pc + i), NULL);
-        memcpy(code + i, &data, sizeof(long));
+    if (debugger_read_memory(pc, code, sizeof(code)) != 0) {
+        return -EFAULT;
     }
-    
+
     cs_insn *insn;
     size_t count = cs_disasm(g_debugger.cs_handle, code, 16, pc, 1, &insn);
     
@@ -344,7 +617,10 @@ int debugger_single_step_analysis(void) {
     if (waitpid(g_debugger.target_pid, &status, 0) == -1) {
         return -errno;
     }
-    
+
+    // The target ran: anything cached may be stale
+    memory_cache_invalidate();
+
     // Update performance statistics
     uint64_t end_time = get_timestamp_ns();
     g_perf_stats.total_overhead_ns += (end_time - start_time);
@@ -424,12 +700,10 @@ int debugger_verify_cfi(uint64_t target_address) {
     
     // Disassemble current instruction
     uint8_t code[16];
-    for (int i = 0; i < 16; i += sizeof(long)) {
-        long data = ptrace(PTRACE_PEEKTEXT, g_debugger.target_pid, 
-                          (void*)(current_pc + i), NULL);
-        memcpy(code + i, &data, sizeof(long));
+    if (debugger_read_memory(current_pc, code, sizeof(code)) != 0) {
+        return -EFAULT;
     }
-    
+
     cs_insn *insn;
     size_t count = cs_disasm(g_debugger.cs_handle, code, 16, current_pc, 1, &insn);
     
@@ -528,13 +802,19 @@ void debugger_cleanup(void) {
         ks_close(g_debugger.ks_handle);
     }
     
-    // Free breakpoint list
+    // Free breakpoint list and lookup table
     breakpoint_t *bp = g_debugger.breakpoints;
     while (bp) {
         breakpoint_t *next = bp->next;
         free(bp);
         bp = next;
     }
-    
+
+    free(bp_hash_table);
+    bp_hash_table = NULL;
+    bp_hash_capacity = 0;
+    bp_hash_count = 0;
+    memory_cache_invalidate();
+
     memset(&g_debugger, 0, sizeof(debugger_context_t));
 } 
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <deque>
+#include <atomic>
 
 #ifdef __ARM_NEON
 #include <arm_neon.h>
@@ -93,6 +95,9 @@ struct GenerationConfig {
     float repetition_penalty = 1.1f;
     std::vector<std::string> stop_sequences;
     bool stream = false;
+    // Streaming callbacks fire once per this many decoded tokens (partial
+    // UTF-8 sequences are held back until complete)
+    int stream_flush_interval = 8;
     int seed = -1;
 };
 
@@ -124,6 +129,9 @@ class Tensor {
 public:
     Tensor() = default;
     Tensor(const std::vector<int64_t>& shape, DataType dtype);
+    // Non-owning view over externally managed memory (e.g. an mmap'd
+    // weight file); the tensor never frees data.
+    Tensor(void* data, const std::vector<int64_t>& shape, DataType dtype);
     ~Tensor();
     
     // Move constructor and assignment
@@ -163,32 +171,137 @@ private:
     void deallocate();
 };
 
-// Memory manager for efficient tensor allocation
+// Block allocator for the paged KV cache. Hands out fixed-size blocks
+// (KV_BLOCK_TOKENS tokens worth of keys+values for one layer) from a
+// single slab, so sequences grow in O(1) increments instead of forcing
+// contiguous per-sequence reservations. The slab itself is reserved from
+// the pool lazily on the first block allocation, so an unused cache costs
+// nothing and constructing one cannot fail.
+class KVBlockAllocator {
+public:
+    static constexpr int KV_BLOCK_TOKENS = 16; // tokens per block
+
+    KVBlockAllocator(std::shared_ptr<MemoryManager> memory_manager,
+                     size_t block_bytes, int num_blocks);
+    ~KVBlockAllocator();
+
+    // Returns a block index, or -1 when the slab is exhausted.
+    int allocateBlock();
+    void freeBlock(int block_id);
+
+    void* blockData(int block_id) const;
+    size_t block_bytes() const { return block_bytes_; }
+    int num_blocks() const { return num_blocks_; }
+    int free_blocks() const;
+
+private:
+    std::shared_ptr<MemoryManager> memory_manager_;
+    void* slab_ = nullptr;
+    size_t block_bytes_;
+    int num_blocks_;
+    std::vector<int> free_list_;
+    mutable std::mutex mutex_;
+};
+
+// Paged KV cache: per-layer block tables mapping logical token positions
+// to physical blocks owned by a KVBlockAllocator. The attention path walks
+// the block table instead of assuming one contiguous tensor per layer.
+class PagedKVCache {
+public:
+    PagedKVCache(std::shared_ptr<KVBlockAllocator> allocator,
+                 int num_layers, int num_heads, int head_dim);
+    ~PagedKVCache();
+
+    // Ensure capacity for one more token; allocates new blocks on demand.
+    // Returns false if the allocator is out of blocks.
+    bool appendToken();
+
+    // Pointers to the K/V storage for a given layer and token position.
+    float* keyAt(int layer, int position) const;
+    float* valueAt(int layer, int position) const;
+
+    int current_length() const { return current_length_; }
+    void reset();
+
+private:
+    std::shared_ptr<KVBlockAllocator> allocator_;
+    int num_layers_;
+    int num_heads_;
+    int head_dim_;
+    int current_length_ = 0;
+
+    // block_tables_[layer] is the ordered list of physical block ids
+    // backing that layer's K/V stream.
+    std::vector<std::vector<int>> block_tables_;
+
+    size_t tokenStride() const; // bytes per token (K+V) within a block
+};
+
+// Memory manager for efficient tensor allocation. Internally a buddy
+// allocator: power-of-two size classes with one free list each, so
+// allocate() is O(log n) instead of a linear scan, and freed blocks
+// coalesce with their buddy immediately so the pool doesn't fragment
+// over long-running sessions.
 class MemoryManager {
 public:
     MemoryManager(size_t pool_size);
     ~MemoryManager();
-    
+
     void* allocate(size_t bytes, size_t alignment = 32);
     void deallocate(void* ptr);
     void reset();
-    
+
+    // Per-thread bump arena for short-lived scratch tensors (attention
+    // tiles, logit buffers). allocateScratch is a pointer bump after the
+    // first call on a thread; resetScratch rewinds that thread's arena in
+    // O(1) at the end of a forward pass.
+    void* allocateScratch(size_t bytes, size_t alignment = 32);
+    void resetScratch();
+
     size_t total_size() const { return pool_size_; }
     size_t used_size() const { return used_size_; }
     size_t available_size() const { return pool_size_ - used_size_; }
-    
+
 private:
+    // Every block starts with a header; user data begins HEADER_BYTES in,
+    // which also fixes the alignment handed back by allocate().
+    static constexpr int MIN_ORDER = 8;          // 256B minimum block
+    static constexpr size_t HEADER_BYTES = 64;
+    static constexpr uint32_t BLOCK_MAGIC = 0xA11C0DE5;
+
+    struct BlockHeader {
+        uint32_t magic;
+        uint8_t order;
+        uint8_t is_free;
+    };
+    struct FreeNode {
+        FreeNode* prev;
+        FreeNode* next;
+    };
+    struct ScratchArena {
+        char* base = nullptr;
+        size_t size = 0;
+        size_t offset = 0;
+    };
+
     void* pool_ = nullptr;
     size_t pool_size_;
     size_t used_size_ = 0;
     std::mutex mutex_;
-    
-    struct Block {
-        void* ptr;
-        size_t size;
-        bool free;
-    };
-    std::vector<Block> blocks_;
+
+    int max_order_ = 0;
+    std::vector<FreeNode*> free_lists_;  // indexed by order
+
+    std::mutex scratch_mutex_;
+    std::unordered_map<std::thread::id, ScratchArena> scratch_arenas_;
+
+    int order_for(size_t bytes) const;
+    BlockHeader* header_at(void* block) const;
+    FreeNode* node_at(void* block) const;
+    void push_free(void* block, int order);
+    void remove_free(void* block, int order);
+    void* allocate_locked(size_t bytes);
+    void seed_free_lists();
 };
 
 // HuggingFace client for model downloading
@@ -206,13 +319,16 @@ public:
     
     // Get model info
     ModelInfo getModelInfo(const std::string& model_id);
-    
+
+    // Parse a downloaded config.json into ModelInfo (used by the runtime
+    // after downloadModel)
+    ModelInfo parse_config(const std::string& config_path);
+
 private:
     std::string cache_dir_;
     std::unordered_map<std::string, ModelInfo> model_cache_;
-    
+
     std::string download_file(const std::string& url, const std::string& path);
-    ModelInfo parse_config(const std::string& config_path);
 };
 
 // Quantization engine for model compression
@@ -241,7 +357,8 @@ private:
 // Main model class
 class Model {
 public:
-    Model(const ModelInfo& info, std::shared_ptr<MemoryManager> memory_manager);
+    Model(const ModelInfo& info, std::shared_ptr<MemoryManager> memory_manager,
+          const RuntimeConfig& runtime_config = {});
     ~Model();
     
     // Generation methods
@@ -257,6 +374,12 @@ public:
                        std::function<void(const std::string&)> callback,
                        const GenerationConfig& config = {});
     
+    // Speculative decoding: attach a small draft model (loaded through the
+    // normal ArmLLMRuntime::loadModel path). When
+    // RuntimeConfig::enable_speculative_decoding is set, generate() drafts
+    // k tokens with it and verifies them in one batched forward here.
+    void setDraftModel(std::shared_ptr<Model> draft_model);
+
     // Model info
     const ModelInfo& info() const { return info_; }
     
@@ -267,24 +390,86 @@ public:
 private:
     ModelInfo info_;
     std::shared_ptr<MemoryManager> memory_manager_;
+    RuntimeConfig runtime_config_;   // Copied from the owning runtime
     std::unique_ptr<InferenceEngine> inference_engine_;
     
     // Model weights and parameters
     std::unordered_map<std::string, Tensor> weights_;
     std::unordered_map<std::string, std::string> tokenizer_config_;
     
-    // KV cache for efficient generation
-    struct KVCache {
-        std::vector<Tensor> keys;
-        std::vector<Tensor> values;
-        int current_length = 0;
-    };
-    KVCache kv_cache_;
+    // Paged KV cache for efficient generation: blocks come from a shared
+    // allocator, so several sessions can coexist in one memory pool
+    // without contiguous per-sequence reservations.
+    std::shared_ptr<KVBlockAllocator> kv_block_allocator_;
+    std::unique_ptr<PagedKVCache> kv_cache_;
     
+    // mmap'd weight file (when RuntimeConfig::enable_mmap is set); weights_
+    // then hold non-owning views into this mapping.
+    void* weight_mapping_ = nullptr;
+    size_t weight_mapping_size_ = 0;
+
+    // Draft model for speculative decoding (may be null)
+    std::shared_ptr<Model> draft_model_;
+
     void load_weights(const std::string& model_path);
+    void load_weights_mmap(const std::string& model_path);
     void load_tokenizer(const std::string& tokenizer_path);
     std::vector<float> forward(const std::vector<int>& tokens);
     int sample_token(const std::vector<float>& logits, const GenerationConfig& config);
+
+    // Streaming detokenizer: decodes one token at a time into a reused
+    // buffer and only releases complete UTF-8 sequences, so partial
+    // multi-byte characters (and BPE merges pending a continuation) carry
+    // over to the next flush instead of being emitted broken.
+    void detokenize_append(int token, std::string& out);
+    static size_t utf8_complete_prefix(const std::string& text);
+
+    // Draft-then-verify decode loop used when speculative decoding is on
+    GenerationResult generate_speculative(const std::string& prompt,
+                                          const GenerationConfig& config);
+};
+
+// Continuous batching scheduler: admits generation requests into an
+// in-flight batch at token granularity, retires finished sequences and
+// backfills from the waiting queue, so decode steps always run as one
+// fused forward across every live sequence instead of one request at a
+// time.
+class ContinuousBatchScheduler {
+public:
+    struct Sequence {
+        int id;
+        std::vector<int> tokens;      // prompt + generated so far
+        int prompt_length;
+        int tokens_generated = 0;
+        GenerationConfig config;
+        bool finished = false;
+        std::function<void(int)> on_token;   // called per generated token
+    };
+
+    explicit ContinuousBatchScheduler(int max_batch_size);
+
+    // Enqueue a request; it joins the in-flight batch as soon as a slot opens.
+    int submit(std::vector<int> prompt_tokens, const GenerationConfig& config,
+               std::function<void(int)> on_token = nullptr);
+
+    // Move waiting sequences into free batch slots. Returns the in-flight set.
+    std::vector<Sequence*> admit();
+
+    // Record one sampled token for a sequence and retire it if done.
+    void recordToken(int sequence_id, int token);
+
+    bool hasWork() const;
+    const Sequence& sequence(int sequence_id) const;
+
+private:
+    int max_batch_size_;
+    int next_id_ = 0;
+    std::deque<int> waiting_;
+    std::vector<int> in_flight_;
+    std::unordered_map<int, Sequence> sequences_;
+    mutable std::mutex mutex_;
+
+    bool isFinished(const Sequence& seq) const;
 };
 
 // Inference engine with ARM optimizations
@@ -297,10 +482,24 @@ public:
     std::vector<float> forward(const std::vector<int>& tokens,
                               const std::unordered_map<std::string, Tensor>& weights,
                               const ModelInfo& model_info);
+
+    // Fused forward across an in-flight batch: one pass produces next-token
+    // logits for every sequence, which is what makes continuous batching pay off.
+    std::vector<std::vector<float>> forwardBatch(
+        const std::vector<const std::vector<int>*>& token_batch,
+        const std::unordered_map<std::string, Tensor>& weights,
+        const ModelInfo& model_info);
     
     // NEON optimized operations
     void matmul_neon(const float* a, const float* b, float* c,
                      int m, int n, int k);
+    // Fused Q4_K dequantize + matmul: B stays 4-bit in memory and is
+    // expanded to float in registers inside the dot-product loop, so the
+    // weight stream costs ~1/8 the bandwidth of dequantize-then-matmul.
+    // B layout: row-major, groups of QuantizationConfig::group_size (128)
+    // values per {float scale, float min, 64 packed nibble bytes} block.
+    void matmul_q4k_neon(const float* a, const void* b_q4k, float* c,
+                         int m, int n, int k, int group_size = 128);
     void add_neon(const float* a, const float* b, float* c, int n);
     void relu_neon(const float* input, float* output, int n);
     void softmax_neon(const float* input, float* output, int n);
@@ -312,23 +511,56 @@ public:
                              const Tensor& value, Tensor& output,
                              int num_heads);
     
+    // Tiled flash attention with online softmax: K/V are streamed in
+    // fixed-size tiles and the running (max, sum, accumulator) triple is
+    // rescaled per tile, so no O(n^2) score matrix ever materializes.
+    // K/V may be FLOAT32 or FLOAT16 (see enable_kv_cache_compression);
+    // fp16 tiles are widened on the fly during the dot products.
     void flash_attention(const Tensor& query, const Tensor& key,
                         const Tensor& value, Tensor& output,
                         int num_heads);
-    
+
+    // KV cache compression (enable_kv_cache_compression): fp32 -> fp16
+    // halves cache bandwidth with negligible quality loss; Q8_0 quarters
+    // it using QuantizationEngine's 32-element block layout.
+    void compress_kv_fp16(const float* input, uint16_t* output, int n);
+    void decompress_kv_fp16(const uint16_t* input, float* output, int n);
+
+    // Attention over a paged KV cache: K/V are gathered through the
+    // block table instead of a contiguous per-layer tensor.
+    void paged_attention(const Tensor& query, const PagedKVCache& kv_cache,
+                        Tensor& output, int layer, int num_heads);
+    
+    // Data-parallel loop over [begin, end): splits the range into chunks
+    // of at least `grain` iterations, fans them out over the work-stealing
+    // pool and has the caller work too instead of blocking. The NEON
+    // kernels use this directly for row tiling.
+    void parallel_for(int begin, int end, int grain,
+                      const std::function<void(int, int)>& body);
+
 private:
     RuntimeConfig config_;
     std::unique_ptr<MemoryManager> memory_manager_;
-    
-    // Thread pool for parallel operations
+
+    // Work-stealing thread pool: one deque per worker. Owners push/pop at
+    // the back (LIFO, cache-warm); idle workers steal from the front of a
+    // victim's deque. No global task lock to serialize dispatch on.
+    struct WorkerQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
     std::vector<std::thread> thread_pool_;
-    std::queue<std::function<void()>> task_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable condition_;
-    bool stop_threads_ = false;
-    
-    void worker_thread();
+    std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+    std::atomic<bool> stop_threads_{false};
+    std::atomic<int> pending_tasks_{0};
+    std::atomic<unsigned> submit_cursor_{0};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_condition_;
+
+    void worker_thread(int worker_id);
     void submit_task(std::function<void()> task);
+    bool try_pop_local(int worker_id, std::function<void()>& task);
+    bool try_steal(int worker_id, std::function<void()>& task);
     void initialize_thread_pool();
     void shutdown_thread_pool();
 };
@@ -4,6 +4,11 @@
 #include <memory>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
 #include <signal.h>
 #include <getopt.h>
 #include "../src/arm_llm_runtime.h"
@@ -28,7 +33,10 @@ void signal_handler(int signal) {
 
 void print_usage(const char* program_name) {
     std::cout << "ARM LLM Runtime - Fast LLM inference on ARM devices\n\n";
-    std::cout << "Usage: " << program_name << " [OPTIONS]\n\n";
+    std::cout << "Usage: " << program_name << " [bench] [OPTIONS]\n\n";
+    std::cout << "Subcommands:\n";
+    std::cout << "  bench                          Run a reproducible inference benchmark\n";
+    std::cout << "                                 (JSON output; see --bench-* options)\n\n";
     std::cout << "Options:\n";
     std::cout << "  -m, --model MODEL_ID          HuggingFace model ID (required)\n";
     std::cout << "  -p, --prompt PROMPT            Input prompt for generation\n";
@@ -43,6 +51,11 @@ void print_usage(const char* program_name) {
     std::cout << "  -n, --threads N                Number of threads (default: auto)\n";
     std::cout << "  -c, --cache-dir DIR            Model cache directory (default: ./models)\n";
     std::cout << "  -M, --memory-size SIZE         Memory pool size (default: 8GB)\n";
+    std::cout << "  --bench-prompt-tokens N        Benchmark prompt length (default: 128)\n";
+    std::cout << "  --bench-output-tokens N        Benchmark output length (default: 128)\n";
+    std::cout << "  --bench-iterations N           Benchmark iterations (default: 3)\n";
+    std::cout << "  --bench-batch-size N           Prompts for the generateBatch phase (default: 4)\n";
+    std::cout << "  --bench-json FILE              Write benchmark JSON to FILE instead of stdout\n";
     std::cout << "  --profile                      Enable performance profiling\n";
     std::cout << "  --verbose                      Verbose output\n";
     std::cout << "  --list-models                  List cached models\n";
@@ -114,6 +127,123 @@ size_t parse_memory_size(const std::string& size_str) {
     return size;
 }
 
+// Benchmark configuration for the `bench` subcommand
+struct BenchOptions {
+    int prompt_tokens = 128;
+    int output_tokens = 128;
+    int iterations = 3;
+    int batch_size = 4;
+    std::string json_path; // empty = print JSON to stdout
+};
+
+static double percentile(std::vector<double> values, double pct) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    double rank = (pct / 100.0) * (values.size() - 1);
+    size_t lo = static_cast<size_t>(rank);
+    size_t hi = std::min(lo + 1, values.size() - 1);
+    double frac = rank - lo;
+    return values[lo] * (1.0 - frac) + values[hi] * frac;
+}
+
+int run_benchmark(std::shared_ptr<Model> model, const BenchOptions& opts,
+                  GenerationConfig gen_config) {
+    using clock = std::chrono::high_resolution_clock;
+
+    gen_config.max_tokens = opts.output_tokens;
+    gen_config.stop_sequences.clear();
+    // One callback per token: the default flush interval of 8 would make
+    // the stamps measure 8-token chunks, not inter-token latency
+    gen_config.stream_flush_interval = 1;
+
+    // Synthetic prompt sized in tokens (the tokenizer is byte-level)
+    std::string prompt(opts.prompt_tokens, 'a');
+
+    std::vector<double> prefill_tps;       // per iteration
+    std::vector<double> decode_tps;        // per iteration
+    std::vector<double> inter_token_ms;    // pooled across iterations
+    size_t peak_memory = 0;
+
+    for (int iter = 0; iter < opts.iterations; ++iter) {
+        std::vector<clock::time_point> stamps;
+        stamps.reserve(opts.output_tokens + 1);
+
+        auto start = clock::now();
+        model->generateStream(prompt, [&](const std::string&) {
+            stamps.push_back(clock::now());
+        }, gen_config);
+
+        if (stamps.empty()) {
+            std::cerr << "bench: model produced no tokens\n";
+            return 1;
+        }
+
+        // Prefill = prompt ingestion up to the first emitted token;
+        // decode = everything after it.
+        double prefill_s = std::chrono::duration<double>(stamps.front() - start).count();
+        prefill_tps.push_back(opts.prompt_tokens / std::max(prefill_s, 1e-9));
+
+        if (stamps.size() > 1) {
+            double decode_s = std::chrono::duration<double>(stamps.back() - stamps.front()).count();
+            decode_tps.push_back((stamps.size() - 1) / std::max(decode_s, 1e-9));
+            for (size_t i = 1; i < stamps.size(); ++i) {
+                inter_token_ms.push_back(
+                    std::chrono::duration<double, std::milli>(stamps[i] - stamps[i - 1]).count());
+            }
+        }
+
+        // Peak pool usage via the non-streaming path, which reports it
+        auto result = model->generate(prompt, gen_config);
+        peak_memory = std::max(peak_memory, result.memory_used);
+    }
+
+    // Batched throughput through generateBatch / the continuous scheduler
+    std::vector<std::string> batch_prompts(opts.batch_size, prompt);
+    auto batch_start = clock::now();
+    auto batch_results = model->generateBatch(batch_prompts, gen_config);
+    double batch_s = std::chrono::duration<double>(clock::now() - batch_start).count();
+
+    size_t batch_tokens = 0;
+    for (const auto& r : batch_results) {
+        batch_tokens += r.tokens_generated;
+        peak_memory = std::max(peak_memory, r.memory_used);
+    }
+    double batch_tps = batch_tokens / std::max(batch_s, 1e-9);
+
+    // Emit JSON so CI can diff runs
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"model\": \"" << model->info().name << "\",\n";
+    json << "  \"prompt_tokens\": " << opts.prompt_tokens << ",\n";
+    json << "  \"output_tokens\": " << opts.output_tokens << ",\n";
+    json << "  \"iterations\": " << opts.iterations << ",\n";
+    json << "  \"batch_size\": " << opts.batch_size << ",\n";
+    json << "  \"prefill_tokens_per_sec\": " << percentile(prefill_tps, 50.0) << ",\n";
+    json << "  \"decode_tokens_per_sec\": " << percentile(decode_tps, 50.0) << ",\n";
+    json << "  \"batch_tokens_per_sec\": " << batch_tps << ",\n";
+    json << "  \"inter_token_latency_ms\": {\n";
+    json << "    \"p50\": " << percentile(inter_token_ms, 50.0) << ",\n";
+    json << "    \"p95\": " << percentile(inter_token_ms, 95.0) << ",\n";
+    json << "    \"p99\": " << percentile(inter_token_ms, 99.0) << "\n";
+    json << "  },\n";
+    json << "  \"peak_memory_bytes\": " << peak_memory << "\n";
+    json << "}\n";
+
+    if (!opts.json_path.empty()) {
+        std::ofstream out(opts.json_path);
+        if (!out) {
+            std::cerr << "bench: cannot write " << opts.json_path << "\n";
+            return 1;
+        }
+        out << json.str();
+        std::cout << "Benchmark results written to " << opts.json_path << "\n";
+    } else {
+        std::cout << json.str();
+    }
+    return 0;
+}
+
 void run_interactive_mode(std::shared_ptr<Model> model, const GenerationConfig& gen_config) {
     std::cout << "\n=== ARM LLM Runtime Interactive Mode ===\n";
     std::cout << "Type 'quit', 'exit', or press Ctrl+C to exit\n";
@@ -199,7 +329,18 @@ int main(int argc, char* argv[]) {
     // Set up signal handling
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
-    
+
+    // `bench` subcommand: consume the word and remember the mode; the
+    // remaining flags are parsed as usual
+    bool bench_mode = false;
+    BenchOptions bench_opts;
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench_mode = true;
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+    }
+
     // Command line options
     std::string model_id;
     std::string prompt;
@@ -230,6 +371,11 @@ int main(int argc, char* argv[]) {
         {"threads", required_argument, 0, 'n'},
         {"cache-dir", required_argument, 0, 'c'},
         {"memory-size", required_argument, 0, 'M'},
+        {"bench-prompt-tokens", required_argument, 0, 0},
+        {"bench-output-tokens", required_argument, 0, 0},
+        {"bench-iterations", required_argument, 0, 0},
+        {"bench-batch-size", required_argument, 0, 0},
+        {"bench-json", required_argument, 0, 0},
         {"profile", no_argument, 0, 0},
         {"verbose", no_argument, 0, 0},
         {"list-models", no_argument, 0, 0},
@@ -293,7 +439,17 @@ int main(int argc, char* argv[]) {
                 return 0;
             case 0:
                 // Long options
-                if (strcmp(long_options[option_index].name, "profile") == 0) {
+                if (strcmp(long_options[option_index].name, "bench-prompt-tokens") == 0) {
+                    bench_opts.prompt_tokens = std::stoi(optarg);
+                } else if (strcmp(long_options[option_index].name, "bench-output-tokens") == 0) {
+                    bench_opts.output_tokens = std::stoi(optarg);
+                } else if (strcmp(long_options[option_index].name, "bench-iterations") == 0) {
+                    bench_opts.iterations = std::stoi(optarg);
+                } else if (strcmp(long_options[option_index].name, "bench-batch-size") == 0) {
+                    bench_opts.batch_size = std::stoi(optarg);
+                } else if (strcmp(long_options[option_index].name, "bench-json") == 0) {
+                    bench_opts.json_path = optarg;
+                } else if (strcmp(long_options[option_index].name, "profile") == 0) {
                     profile = true;
                 } else if (strcmp(long_options[option_index].name, "verbose") == 0) {
                     verbose = true;
@@ -351,7 +507,7 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
-        if (!interactive && prompt.empty()) {
+        if (!interactive && !bench_mode && prompt.empty()) {
             std::cerr << "Error: Either prompt (-p) or interactive mode (-i) is required.\n";
             print_usage(argv[0]);
             return 1;
@@ -378,6 +534,9 @@ int main(int argc, char* argv[]) {
         }
         
         // Run inference
+        if (bench_mode) {
+            return run_benchmark(g_current_model, bench_opts, gen_config);
+        }
         if (interactive) {
             run_interactive_mode(g_current_model, gen_config);
         } else {
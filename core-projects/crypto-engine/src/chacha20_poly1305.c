@@ -21,6 +21,11 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/uio.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 // ChaCha20 constants
 #define CHACHA20_BLOCK_SIZE 64
@@ -31,6 +36,7 @@
 // Performance counters
 typedef struct {
     uint64_t blocks_processed;
+    uint64_t simd_blocks;       // blocks produced by a multi-block kernel
     uint64_t bytes_encrypted;
     uint64_t bytes_decrypted;
     uint64_t operations_count;
@@ -39,6 +45,16 @@ typedef struct {
 
 static crypto_stats_t global_stats;
 
+// SIMD implementation selected once by CPUID
+typedef enum {
+    CHACHA_IMPL_SCALAR,
+    CHACHA_IMPL_AVX2,     // 8 interleaved blocks, one state word per ymm
+    CHACHA_IMPL_AVX512    // 16 interleaved blocks, one state word per zmm
+} chacha_impl_t;
+
+static chacha_impl_t chacha_impl = CHACHA_IMPL_SCALAR;
+static int chacha_impl_detected;
+
 // ChaCha20 state structure
 typedef struct {
     uint32_t state[16];
@@ -130,6 +146,194 @@ static void chacha20_block(const uint32_t key[8], const uint32_t nonce[3],
     }
 }
 
+// Multi-block SIMD kernels
+//
+// Layout is "vertical": vector register i holds state word i across N
+// independent blocks, the only per-lane difference being the counter.
+// The 20 rounds then run on all N blocks at once with no shuffling; the
+// lanes are only untangled when the keystream is XORed into the data.
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx2")))
+static void chacha20_xor_8blocks_avx2(const uint32_t key[8], const uint32_t nonce[3],
+                                      uint32_t counter, const uint8_t *in, uint8_t *out) {
+    const __m256i rot16 = _mm256_set_epi8(
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8 = _mm256_set_epi8(
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+
+    __m256i x[16], orig[16];
+
+    orig[0] = _mm256_set1_epi32(0x61707865);
+    orig[1] = _mm256_set1_epi32(0x3320646e);
+    orig[2] = _mm256_set1_epi32(0x79622d32);
+    orig[3] = _mm256_set1_epi32(0x6b206574);
+    for (int i = 0; i < 8; i++) {
+        orig[4 + i] = _mm256_set1_epi32((int)key[i]);
+    }
+    orig[12] = _mm256_add_epi32(_mm256_set1_epi32((int)counter),
+                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    orig[13] = _mm256_set1_epi32((int)nonce[0]);
+    orig[14] = _mm256_set1_epi32((int)nonce[1]);
+    orig[15] = _mm256_set1_epi32((int)nonce[2]);
+
+    for (int i = 0; i < 16; i++) {
+        x[i] = orig[i];
+    }
+
+#define VQR256(a, b, c, d)                                                  \
+    x[a] = _mm256_add_epi32(x[a], x[b]);                                    \
+    x[d] = _mm256_shuffle_epi8(_mm256_xor_si256(x[d], x[a]), rot16);        \
+    x[c] = _mm256_add_epi32(x[c], x[d]);                                    \
+    x[b] = _mm256_xor_si256(x[b], x[c]);                                    \
+    x[b] = _mm256_or_si256(_mm256_slli_epi32(x[b], 12),                     \
+                           _mm256_srli_epi32(x[b], 20));                    \
+    x[a] = _mm256_add_epi32(x[a], x[b]);                                    \
+    x[d] = _mm256_shuffle_epi8(_mm256_xor_si256(x[d], x[a]), rot8);         \
+    x[c] = _mm256_add_epi32(x[c], x[d]);                                    \
+    x[b] = _mm256_xor_si256(x[b], x[c]);                                    \
+    x[b] = _mm256_or_si256(_mm256_slli_epi32(x[b], 7),                      \
+                           _mm256_srli_epi32(x[b], 25));
+
+    for (int i = 0; i < 10; i++) {
+        VQR256(0, 4, 8, 12);  VQR256(1, 5, 9, 13);
+        VQR256(2, 6, 10, 14); VQR256(3, 7, 11, 15);
+        VQR256(0, 5, 10, 15); VQR256(1, 6, 11, 12);
+        VQR256(2, 7, 8, 13);  VQR256(3, 4, 9, 14);
+    }
+#undef VQR256
+
+    uint32_t lanes[16][8];
+    for (int i = 0; i < 16; i++) {
+        x[i] = _mm256_add_epi32(x[i], orig[i]);
+        _mm256_storeu_si256((__m256i *)lanes[i], x[i]);
+    }
+
+    // Untangle lanes: block b's keystream word i is lanes[i][b]
+    for (int b = 0; b < 8; b++) {
+        for (int i = 0; i < 16; i++) {
+            size_t off = (size_t)b * 64 + (size_t)i * 4;
+            store32_le(out + off, load32_le(in + off) ^ lanes[i][b]);
+        }
+    }
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void chacha20_xor_16blocks_avx512(const uint32_t key[8], const uint32_t nonce[3],
+                                         uint32_t counter, const uint8_t *in, uint8_t *out) {
+    __m512i x[16], orig[16];
+
+    orig[0] = _mm512_set1_epi32(0x61707865);
+    orig[1] = _mm512_set1_epi32(0x3320646e);
+    orig[2] = _mm512_set1_epi32(0x79622d32);
+    orig[3] = _mm512_set1_epi32(0x6b206574);
+    for (int i = 0; i < 8; i++) {
+        orig[4 + i] = _mm512_set1_epi32((int)key[i]);
+    }
+    orig[12] = _mm512_add_epi32(
+        _mm512_set1_epi32((int)counter),
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    orig[13] = _mm512_set1_epi32((int)nonce[0]);
+    orig[14] = _mm512_set1_epi32((int)nonce[1]);
+    orig[15] = _mm512_set1_epi32((int)nonce[2]);
+
+    for (int i = 0; i < 16; i++) {
+        x[i] = orig[i];
+    }
+
+#define VQR512(a, b, c, d)                                                  \
+    x[a] = _mm512_add_epi32(x[a], x[b]);                                    \
+    x[d] = _mm512_rol_epi32(_mm512_xor_si512(x[d], x[a]), 16);              \
+    x[c] = _mm512_add_epi32(x[c], x[d]);                                    \
+    x[b] = _mm512_rol_epi32(_mm512_xor_si512(x[b], x[c]), 12);              \
+    x[a] = _mm512_add_epi32(x[a], x[b]);                                    \
+    x[d] = _mm512_rol_epi32(_mm512_xor_si512(x[d], x[a]), 8);               \
+    x[c] = _mm512_add_epi32(x[c], x[d]);                                    \
+    x[b] = _mm512_rol_epi32(_mm512_xor_si512(x[b], x[c]), 7);
+
+    for (int i = 0; i < 10; i++) {
+        VQR512(0, 4, 8, 12);  VQR512(1, 5, 9, 13);
+        VQR512(2, 6, 10, 14); VQR512(3, 7, 11, 15);
+        VQR512(0, 5, 10, 15); VQR512(1, 6, 11, 12);
+        VQR512(2, 7, 8, 13);  VQR512(3, 4, 9, 14);
+    }
+#undef VQR512
+
+    uint32_t lanes[16][16];
+    for (int i = 0; i < 16; i++) {
+        x[i] = _mm512_add_epi32(x[i], orig[i]);
+        _mm512_storeu_si512((__m512i *)lanes[i], x[i]);
+    }
+
+    for (int b = 0; b < 16; b++) {
+        for (int i = 0; i < 16; i++) {
+            size_t off = (size_t)b * 64 + (size_t)i * 4;
+            store32_le(out + off, load32_le(in + off) ^ lanes[i][b]);
+        }
+    }
+}
+
+#endif  // __x86_64__
+
+static void chacha_detect_impl(void) {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        chacha_impl = CHACHA_IMPL_AVX512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        chacha_impl = CHACHA_IMPL_AVX2;
+    }
+#endif
+    chacha_impl_detected = 1;
+}
+
+// Encrypt/decrypt `len` bytes: widest available kernel for the bulk,
+// scalar single blocks for the remainder
+static void chacha20_xor_stream(const uint32_t *key, const uint32_t *nonce,
+                                uint32_t counter, const uint8_t *in,
+                                uint8_t *out, size_t len) {
+    if (!chacha_impl_detected) {
+        chacha_detect_impl();
+    }
+
+    size_t offset = 0;
+
+#if defined(__x86_64__)
+    if (chacha_impl == CHACHA_IMPL_AVX512) {
+        while (len - offset >= 16 * CHACHA20_BLOCK_SIZE) {
+            chacha20_xor_16blocks_avx512(key, nonce, counter, in + offset, out + offset);
+            counter += 16;
+            offset += 16 * CHACHA20_BLOCK_SIZE;
+            global_stats.simd_blocks += 16;
+        }
+    }
+    if (chacha_impl >= CHACHA_IMPL_AVX2) {
+        while (len - offset >= 8 * CHACHA20_BLOCK_SIZE) {
+            chacha20_xor_8blocks_avx2(key, nonce, counter, in + offset, out + offset);
+            counter += 8;
+            offset += 8 * CHACHA20_BLOCK_SIZE;
+            global_stats.simd_blocks += 8;
+        }
+    }
+#endif
+
+    while (offset < len) {
+        uint8_t keystream[CHACHA20_BLOCK_SIZE];
+        chacha20_block(key, nonce, counter++, keystream);
+
+        size_t chunk_len = len - offset;
+        if (chunk_len > CHACHA20_BLOCK_SIZE) {
+            chunk_len = CHACHA20_BLOCK_SIZE;
+        }
+        for (size_t j = 0; j < chunk_len; j++) {
+            out[offset + j] = in[offset + j] ^ keystream[j];
+        }
+        offset += chunk_len;
+    }
+}
+
 // Poly1305 initialization
 static void poly1305_init(poly1305_ctx_t *ctx, const uint8_t key[32]) {
     // Extract r (clamped)
@@ -314,7 +518,7 @@ int chacha20_poly1305_encrypt(const uint8_t *key, const uint8_t *nonce,
     uint64_t start_cycles = rdtsc();
     
     // Generate Poly1305 key
-    uint8_t poly_key[32];
+    uint8_t poly_key[64];  // one full keystream block; Poly1305 uses the first 32 bytes
     chacha20_block((uint32_t*)key, (uint32_t*)nonce, 0, poly_key);
     
     // Initialize Poly1305
@@ -332,17 +536,9 @@ int chacha20_poly1305_encrypt(const uint8_t *key, const uint8_t *nonce,
         }
     }
     
-    // Encrypt plaintext
-    uint32_t counter = 1;
-    for (size_t i = 0; i < plaintext_len; i += 64) {
-        uint8_t keystream[64];
-        chacha20_block((uint32_t*)key, (uint32_t*)nonce, counter++, keystream);
-        
-        size_t chunk_len = (plaintext_len - i < 64) ? plaintext_len - i : 64;
-        for (size_t j = 0; j < chunk_len; j++) {
-            ciphertext[i + j] = plaintext[i + j] ^ keystream[j];
-        }
-    }
+    // Encrypt plaintext (multi-block SIMD kernel when available)
+    chacha20_xor_stream((uint32_t*)key, (uint32_t*)nonce, 1,
+                        plaintext, ciphertext, plaintext_len);
     
     // Authenticate ciphertext
     poly1305_update(&poly_ctx, ciphertext, plaintext_len);
@@ -386,7 +582,7 @@ int chacha20_poly1305_decrypt(const uint8_t *key, const uint8_t *nonce,
     uint64_t start_cycles = rdtsc();
     
     // Generate Poly1305 key
-    uint8_t poly_key[32];
+    uint8_t poly_key[64];  // one full keystream block; Poly1305 uses the first 32 bytes
     chacha20_block((uint32_t*)key, (uint32_t*)nonce, 0, poly_key);
     
     // Initialize Poly1305
@@ -433,17 +629,9 @@ int chacha20_poly1305_decrypt(const uint8_t *key, const uint8_t *nonce,
         return -1; // Authentication failed
     }
     
-    // Decrypt ciphertext
-    uint32_t counter = 1;
-    for (size_t i = 0; i < ciphertext_len; i += 64) {
-        uint8_t keystream[64];
-        chacha20_block((uint32_t*)key, (uint32_t*)nonce, counter++, keystream);
-        
-        size_t chunk_len = (ciphertext_len - i < 64) ? ciphertext_len - i : 64;
-        for (size_t j = 0; j < chunk_len; j++) {
-            plaintext[i + j] = ciphertext[i + j] ^ keystream[j];
-        }
-    }
+    // Decrypt ciphertext (multi-block SIMD kernel when available)
+    chacha20_xor_stream((uint32_t*)key, (uint32_t*)nonce, 1,
+                        ciphertext, plaintext, ciphertext_len);
     
     // Update statistics
     uint64_t end_cycles = rdtsc();
@@ -459,6 +647,211 @@ int chacha20_poly1305_decrypt(const uint8_t *key, const uint8_t *nonce,
     return 0;
 }
 
+// Streaming scatter-gather AEAD
+//
+// init/update/final over iovecs: data is encrypted in place, so large
+// streams need no staging copies, and the Poly1305 accumulator is fed
+// right after each chunk is transformed — while the ciphertext is still
+// in cache — instead of in a second pass over the whole stream.
+
+// 2-way Horner split: one pair of 16-byte blocks per step,
+//   h = (h + c0)*r^2 + c1*r
+// The two multiplies are independent, so they pipeline instead of
+// serializing on the single Horner chain.
+static void poly1305_update_2way(poly1305_ctx_t *ctx, const uint8_t *m, size_t bytes) {
+    if (ctx->leftover || bytes < 32) {
+        poly1305_update(ctx, m, bytes);
+        return;
+    }
+
+    uint32_t r2[5];
+    memcpy(r2, ctx->r, sizeof(r2));
+    poly1305_multiply(r2, ctx->r);
+
+    while (bytes >= 32) {
+        uint32_t c0[5], c1[5];
+        c0[0] = load32_le(m) & 0x3ffffff;
+        c0[1] = (load32_le(m + 3) >> 2) & 0x3ffffff;
+        c0[2] = (load32_le(m + 6) >> 4) & 0x3ffffff;
+        c0[3] = (load32_le(m + 9) >> 6) & 0x3ffffff;
+        c0[4] = (load32_le(m + 12) >> 8) | (1 << 24);
+
+        c1[0] = load32_le(m + 16) & 0x3ffffff;
+        c1[1] = (load32_le(m + 19) >> 2) & 0x3ffffff;
+        c1[2] = (load32_le(m + 22) >> 4) & 0x3ffffff;
+        c1[3] = (load32_le(m + 25) >> 6) & 0x3ffffff;
+        c1[4] = (load32_le(m + 28) >> 8) | (1 << 24);
+
+        poly1305_add(ctx->h, c0);
+        poly1305_multiply(ctx->h, r2);   // (h + c0) * r^2
+        poly1305_multiply(c1, ctx->r);   // c1 * r, independent chain
+        poly1305_add(ctx->h, c1);
+
+        m += 32;
+        bytes -= 32;
+    }
+
+    if (bytes) {
+        poly1305_update(ctx, m, bytes);
+    }
+}
+
+// Streaming AEAD context
+typedef struct {
+    uint32_t key[8];
+    uint32_t nonce[3];
+    uint32_t counter;            // next keystream block
+    poly1305_ctx_t poly;
+    uint8_t ks_partial[64];      // unused tail of the last keystream block
+    uint32_t ks_off;             // consumed bytes of ks_partial (0 = none)
+    uint64_t aad_len;
+    uint64_t data_len;
+    int aad_finished;
+    int encrypt;                 // 1 = encrypt, 0 = decrypt
+} chacha20_poly1305_stream_t;
+
+int chacha20_poly1305_stream_init(chacha20_poly1305_stream_t *stream,
+                                  const uint8_t *key, const uint8_t *nonce,
+                                  int encrypt) {
+    memset(stream, 0, sizeof(*stream));
+    memcpy(stream->key, key, CHACHA20_KEY_SIZE);
+    memcpy(stream->nonce, nonce, CHACHA20_NONCE_SIZE);
+    stream->counter = 1;
+    stream->encrypt = encrypt;
+
+    uint8_t poly_key[64];
+    chacha20_block(stream->key, stream->nonce, 0, poly_key);
+    poly1305_init(&stream->poly, poly_key);
+    memset(poly_key, 0, sizeof(poly_key));
+
+    return 0;
+}
+
+// AAD must be fed before any data
+int chacha20_poly1305_stream_aad(chacha20_poly1305_stream_t *stream,
+                                 const uint8_t *aad, size_t aad_len) {
+    if (stream->aad_finished) {
+        return -1;
+    }
+    poly1305_update_2way(&stream->poly, aad, aad_len);
+    stream->aad_len += aad_len;
+    return 0;
+}
+
+static void stream_finish_aad(chacha20_poly1305_stream_t *stream) {
+    if (stream->aad_finished) {
+        return;
+    }
+    if (stream->aad_len % 16) {
+        uint8_t pad[16] = {0};
+        poly1305_update(&stream->poly, pad, 16 - (stream->aad_len % 16));
+    }
+    stream->aad_finished = 1;
+}
+
+// Transform one contiguous chunk in place, carrying partial keystream
+// blocks across chunk boundaries
+static void stream_xor_chunk(chacha20_poly1305_stream_t *stream,
+                             uint8_t *data, size_t len) {
+    size_t offset = 0;
+
+    // Finish the keystream block left over from the previous chunk
+    while (stream->ks_off && offset < len) {
+        data[offset++] ^= stream->ks_partial[stream->ks_off];
+        stream->ks_off = (stream->ks_off + 1) % CHACHA20_BLOCK_SIZE;
+    }
+
+    // Bulk: whole blocks through the SIMD-dispatched path
+    size_t bulk = (len - offset) & ~(size_t)(CHACHA20_BLOCK_SIZE - 1);
+    if (bulk) {
+        chacha20_xor_stream(stream->key, stream->nonce, stream->counter,
+                            data + offset, data + offset, bulk);
+        stream->counter += bulk / CHACHA20_BLOCK_SIZE;
+        offset += bulk;
+    }
+
+    // Tail: generate one block, keep the rest for the next chunk
+    if (offset < len) {
+        chacha20_block(stream->key, stream->nonce, stream->counter++,
+                       stream->ks_partial);
+        while (offset < len) {
+            data[offset++] ^= stream->ks_partial[stream->ks_off++];
+        }
+        stream->ks_off %= CHACHA20_BLOCK_SIZE;
+    }
+}
+
+// Encrypt or decrypt an iovec in place. Poly1305 always runs over the
+// ciphertext: after the XOR when encrypting, before it when decrypting,
+// in both cases while the chunk is still cache-resident.
+int chacha20_poly1305_stream_update(chacha20_poly1305_stream_t *stream,
+                                    const struct iovec *iov, int iovcnt) {
+    uint64_t start_cycles = rdtsc();
+
+    stream_finish_aad(stream);
+
+    for (int i = 0; i < iovcnt; i++) {
+        uint8_t *data = iov[i].iov_base;
+        size_t len = iov[i].iov_len;
+
+        if (stream->encrypt) {
+            stream_xor_chunk(stream, data, len);
+            poly1305_update_2way(&stream->poly, data, len);
+        } else {
+            poly1305_update_2way(&stream->poly, data, len);
+            stream_xor_chunk(stream, data, len);
+        }
+
+        stream->data_len += len;
+        if (stream->encrypt) {
+            global_stats.bytes_encrypted += len;
+        } else {
+            global_stats.bytes_decrypted += len;
+        }
+        global_stats.blocks_processed += (len + 63) / 64;
+    }
+
+    global_stats.operations_count++;
+    global_stats.total_cycles += rdtsc() - start_cycles;
+    return 0;
+}
+
+// Produce the tag and wipe the context
+int chacha20_poly1305_stream_final(chacha20_poly1305_stream_t *stream,
+                                   uint8_t tag[16]) {
+    stream_finish_aad(stream);
+
+    if (stream->data_len % 16) {
+        uint8_t pad[16] = {0};
+        poly1305_update(&stream->poly, pad, 16 - (stream->data_len % 16));
+    }
+
+    uint8_t len_bytes[16];
+    store32_le(len_bytes, stream->aad_len);
+    store32_le(len_bytes + 4, stream->aad_len >> 32);
+    store32_le(len_bytes + 8, stream->data_len);
+    store32_le(len_bytes + 12, stream->data_len >> 32);
+    poly1305_update(&stream->poly, len_bytes, 16);
+
+    poly1305_finish(&stream->poly, tag);
+
+    memset(stream, 0, sizeof(*stream));
+    return 0;
+}
+
+// Decrypt-side convenience: finalize and compare in constant time
+int chacha20_poly1305_stream_verify(chacha20_poly1305_stream_t *stream,
+                                    const uint8_t tag[16]) {
+    uint8_t computed_tag[16];
+    chacha20_poly1305_stream_final(stream, computed_tag);
+
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; i++) {
+        diff |= tag[i] ^ computed_tag[i];
+    }
+    return diff ? -1 : 0;
+}
+
 // Get performance statistics
 void crypto_get_stats(crypto_stats_t *stats) {
     memcpy(stats, &global_stats, sizeof(crypto_stats_t));
@@ -467,6 +860,7 @@ void crypto_get_stats(crypto_stats_t *stats) {
 // Initialize crypto engine
 void crypto_engine_init(void) {
     memset(&global_stats, 0, sizeof(global_stats));
+    chacha_detect_impl();
 }
 
 // Benchmark function
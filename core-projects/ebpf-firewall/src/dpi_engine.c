@@ -0,0 +1,373 @@
+/*
+ * AF_XDP Deep Packet Inspection Engine
+ *
+ * Userspace companion to xdp_firewall: the XDP program redirects the
+ * first payload packets of each unverdicted TCP flow to an AF_XDP
+ * socket (zero-copy UMEM when the NIC supports it). This engine runs
+ * the pattern matching the verifier won't let us do in-kernel, then
+ * writes an allow/drop verdict back into the pinned connection_map so
+ * the remaining 98% of traffic never leaves the <100ns XDP fast path.
+ *
+ * Usage: dpi_engine <interface> [queue]
+ *
+ * Author: Amelia Enora
+ * Date: June 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/ip.h>
+#include <linux/tcp.h>
+#include <linux/if_ether.h>
+#include <linux/if_xdp.h>
+#include <bpf/bpf.h>
+#include <xdp/xsk.h>
+
+#define PIN_DIR "/sys/fs/bpf/xdp_firewall"
+
+#define NUM_FRAMES      4096
+#define FRAME_SIZE      XSK_UMEM__DEFAULT_FRAME_SIZE
+#define RX_BATCH_SIZE   64
+
+// Must match the kernel-side definitions in xdp_firewall.c
+struct connection_key {
+    __u32 src_ip;
+    __u32 dst_ip;
+    __u16 src_port;
+    __u16 dst_port;
+    __u8 protocol;
+    __u8 reserved[3];
+};
+
+struct connection_state {
+    __u64 first_seen;
+    __u64 last_seen;
+    __u64 packets;
+    __u64 bytes;
+    __u32 state;
+    __u32 flags;
+};
+
+#define CONN_FLAG_DPI_ALLOW 0x100
+#define CONN_FLAG_DPI_DROP  0x200
+
+// Threat signatures: patterns too expensive to scan for in-kernel
+static const struct {
+    const char *pattern;
+    const char *name;
+} signatures[] = {
+    { "SELECT ",            "sql-injection" },
+    { "UNION SELECT",       "sql-injection" },
+    { "' OR '1'='1",        "sql-injection" },
+    { "<script",            "xss" },
+    { "../../",             "path-traversal" },
+    { "/etc/passwd",        "path-traversal" },
+    { "\x90\x90\x90\x90",   "nop-sled" },
+    { "() { :;};",          "shellshock" },
+};
+
+#define NUM_SIGNATURES (sizeof(signatures) / sizeof(signatures[0]))
+
+struct dpi_stats {
+    __u64 packets;
+    __u64 bytes;
+    __u64 flows_allowed;
+    __u64 flows_dropped;
+};
+
+static volatile int running = 1;
+static int conn_map_fd = -1;
+static struct dpi_stats dpi_stats;
+
+static void signal_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+// Case-sensitive search; payload is not NUL-terminated
+static const char *match_signatures(const __u8 *payload, size_t len) {
+    for (size_t s = 0; s < NUM_SIGNATURES; s++) {
+        size_t plen = strlen(signatures[s].pattern);
+        if (len < plen) {
+            continue;
+        }
+        for (size_t i = 0; i + plen <= len; i++) {
+            if (memcmp(payload + i, signatures[s].pattern, plen) == 0) {
+                return signatures[s].name;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Write the verdict into the shared connection table; the XDP program
+// enforces it on the very next packet of the flow
+static void deliver_verdict(struct connection_key *key, int drop) {
+    struct connection_state conn;
+
+    if (bpf_map_lookup_elem(conn_map_fd, key, &conn) < 0) {
+        return;  // Flow aged out while we were inspecting
+    }
+
+    conn.flags &= ~(CONN_FLAG_DPI_ALLOW | CONN_FLAG_DPI_DROP);
+    conn.flags |= drop ? CONN_FLAG_DPI_DROP : CONN_FLAG_DPI_ALLOW;
+    bpf_map_update_elem(conn_map_fd, key, &conn, BPF_EXIST);
+
+    if (drop) {
+        dpi_stats.flows_dropped++;
+    } else {
+        dpi_stats.flows_allowed++;
+    }
+}
+
+// Full inspection of one redirected frame. Returns 1 if the frame
+// itself must be dropped (signature hit); anything else — including
+// frames too short or non-TCP to inspect — is forwarded, since the XDP
+// program only redirects, it does not consume.
+static int inspect_packet(const __u8 *pkt, size_t len) {
+    dpi_stats.packets++;
+    dpi_stats.bytes += len;
+
+    if (len < sizeof(struct ethhdr) + sizeof(struct iphdr)) {
+        return 0;
+    }
+
+    const struct ethhdr *eth = (const struct ethhdr *)pkt;
+    if (eth->h_proto != htons(ETH_P_IP)) {
+        return 0;
+    }
+
+    const struct iphdr *ip = (const struct iphdr *)(eth + 1);
+    size_t ip_len = ip->ihl * 4;
+    if (ip->protocol != IPPROTO_TCP ||
+        sizeof(struct ethhdr) + ip_len + sizeof(struct tcphdr) > len) {
+        return 0;
+    }
+
+    const struct tcphdr *tcp = (const struct tcphdr *)((const __u8 *)ip + ip_len);
+    size_t tcp_len = tcp->doff * 4;
+    size_t payload_off = sizeof(struct ethhdr) + ip_len + tcp_len;
+    if (payload_off >= len) {
+        return 0;
+    }
+
+    struct connection_key key = {
+        .src_ip = ntohl(ip->saddr),
+        .dst_ip = ntohl(ip->daddr),
+        .src_port = ntohs(tcp->source),
+        .dst_port = ntohs(tcp->dest),
+        .protocol = IPPROTO_TCP
+    };
+
+    const char *threat = match_signatures(pkt + payload_off, len - payload_off);
+    if (threat) {
+        char src[INET_ADDRSTRLEN];
+        __u32 saddr = ip->saddr;
+        inet_ntop(AF_INET, &saddr, src, sizeof(src));
+        printf("DROP %s:%u -> :%u (%s)\n", src, key.src_port, key.dst_port, threat);
+        deliver_verdict(&key, 1);
+        return 1;
+    }
+
+    deliver_verdict(&key, 0);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <interface> [queue]\n", argv[0]);
+        return 1;
+    }
+
+    const char *ifname = argv[1];
+    __u32 queue_id = (argc > 2) ? atoi(argv[2]) : 0;
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    conn_map_fd = bpf_obj_get(PIN_DIR "/connection_map");
+    if (conn_map_fd < 0) {
+        fprintf(stderr, "Failed to open pinned connection_map: %s\n",
+                strerror(errno));
+        return 1;
+    }
+
+    // UMEM shared with the kernel: redirected frames land here without
+    // a copy when the driver supports XDP_ZEROCOPY
+    void *umem_area;
+    if (posix_memalign(&umem_area, getpagesize(),
+                       (size_t)NUM_FRAMES * FRAME_SIZE) != 0) {
+        fprintf(stderr, "Failed to allocate UMEM\n");
+        return 1;
+    }
+
+    struct xsk_umem *umem;
+    struct xsk_ring_prod fill_ring;
+    struct xsk_ring_cons comp_ring;
+    if (xsk_umem__create(&umem, umem_area, (size_t)NUM_FRAMES * FRAME_SIZE,
+                         &fill_ring, &comp_ring, NULL) < 0) {
+        fprintf(stderr, "Failed to create UMEM: %s\n", strerror(errno));
+        return 1;
+    }
+
+    struct xsk_socket_config cfg = {
+        .rx_size = XSK_RING_CONS__DEFAULT_NUM_DESCS,
+        .tx_size = XSK_RING_PROD__DEFAULT_NUM_DESCS,
+        .bind_flags = XDP_ZEROCOPY,
+    };
+
+    struct xsk_socket *xsk;
+    struct xsk_ring_cons rx_ring;
+    struct xsk_ring_prod tx_ring;
+    int err = xsk_socket__create(&xsk, ifname, queue_id, umem,
+                                 &rx_ring, &tx_ring, &cfg);
+    if (err == -EOPNOTSUPP) {
+        // NIC can't do zero-copy; fall back to copy mode
+        cfg.bind_flags = XDP_COPY;
+        err = xsk_socket__create(&xsk, ifname, queue_id, umem,
+                                 &rx_ring, &tx_ring, &cfg);
+    }
+    if (err < 0) {
+        fprintf(stderr, "Failed to create AF_XDP socket on %s queue %u: %s\n",
+                ifname, queue_id, strerror(-err));
+        return 1;
+    }
+
+    // Register the socket in xsk_map so the XDP program can redirect
+    int xsk_map_fd = bpf_obj_get(PIN_DIR "/xsk_map");
+    if (xsk_map_fd < 0) {
+        fprintf(stderr, "Failed to open pinned xsk_map: %s\n", strerror(errno));
+        return 1;
+    }
+    int sock_fd = xsk_socket__fd(xsk);
+    if (bpf_map_update_elem(xsk_map_fd, &queue_id, &sock_fd, BPF_ANY) < 0) {
+        fprintf(stderr, "Failed to register socket in xsk_map: %s\n",
+                strerror(errno));
+        return 1;
+    }
+
+    // Seed the fill ring with every frame
+    __u32 idx;
+    xsk_ring_prod__reserve(&fill_ring, NUM_FRAMES, &idx);
+    for (__u32 i = 0; i < NUM_FRAMES; i++) {
+        *xsk_ring_prod__fill_addr(&fill_ring, idx + i) = (__u64)i * FRAME_SIZE;
+    }
+    xsk_ring_prod__submit(&fill_ring, NUM_FRAMES);
+
+    printf("DPI engine on %s queue %u (%s mode), %zu signatures loaded\n",
+           ifname, queue_id,
+           cfg.bind_flags & XDP_ZEROCOPY ? "zero-copy" : "copy",
+           NUM_SIGNATURES);
+
+    struct pollfd pfd = { .fd = sock_fd, .events = POLLIN };
+    int verdicts[RX_BATCH_SIZE];
+
+    while (running) {
+        if (poll(&pfd, 1, 100) <= 0) {
+            continue;
+        }
+
+        __u32 rx_idx;
+        __u32 rcvd = xsk_ring_cons__peek(&rx_ring, RX_BATCH_SIZE, &rx_idx);
+        if (rcvd == 0) {
+            continue;
+        }
+
+        // First pass: verdicts only, so each ring can be reserved for
+        // exactly the frames it will carry
+        __u32 n_tx = 0;
+        for (__u32 i = 0; i < rcvd; i++) {
+            const struct xdp_desc *desc =
+                xsk_ring_cons__rx_desc(&rx_ring, rx_idx + i);
+            verdicts[i] = inspect_packet((__u8 *)umem_area + desc->addr,
+                                         desc->len);
+            if (!verdicts[i]) {
+                n_tx++;
+            }
+        }
+
+        // Clean frames are re-injected through TX so inspection is not
+        // destructive; if the TX ring has no room the batch is recycled
+        // instead of leaked. Dropped frames go straight back to the
+        // fill ring.
+        __u32 tx_idx = 0;
+        __u32 tx_got = n_tx ? xsk_ring_prod__reserve(&tx_ring, n_tx, &tx_idx) : 0;
+        __u32 n_fill = rcvd - tx_got;
+
+        __u32 fill_idx = 0;
+        if (n_fill) {
+            // Every frame here came out of the fill/RX cycle, so the
+            // slots are guaranteed to free up
+            while (xsk_ring_prod__reserve(&fill_ring, n_fill, &fill_idx) < n_fill) {
+            }
+        }
+
+        __u32 tx_used = 0, fill_used = 0;
+        for (__u32 i = 0; i < rcvd; i++) {
+            const struct xdp_desc *desc =
+                xsk_ring_cons__rx_desc(&rx_ring, rx_idx + i);
+
+            if (!verdicts[i] && tx_used < tx_got) {
+                struct xdp_desc *tx_desc =
+                    xsk_ring_prod__tx_desc(&tx_ring, tx_idx + tx_used);
+                tx_desc->addr = desc->addr;
+                tx_desc->len = desc->len;
+                tx_desc->options = 0;
+                tx_used++;
+            } else {
+                // Recycle the frame
+                *xsk_ring_prod__fill_addr(&fill_ring, fill_idx + fill_used) =
+                    desc->addr & ~((__u64)FRAME_SIZE - 1);
+                fill_used++;
+            }
+        }
+
+        if (tx_used) {
+            xsk_ring_prod__submit(&tx_ring, tx_used);
+            // Copy mode needs an explicit kick to start transmitting
+            if (xsk_ring_prod__needs_wakeup(&tx_ring)) {
+                sendto(sock_fd, NULL, 0, MSG_DONTWAIT, NULL, 0);
+            }
+        }
+        if (fill_used) {
+            xsk_ring_prod__submit(&fill_ring, fill_used);
+        }
+        xsk_ring_cons__release(&rx_ring, rcvd);
+
+        // Frames the NIC has finished sending come back through the
+        // completion ring and rejoin the RX circulation
+        __u32 comp_idx;
+        __u32 done = xsk_ring_cons__peek(&comp_ring, RX_BATCH_SIZE, &comp_idx);
+        if (done > 0) {
+            __u32 cidx;
+            while (xsk_ring_prod__reserve(&fill_ring, done, &cidx) < done) {
+            }
+            for (__u32 i = 0; i < done; i++) {
+                *xsk_ring_prod__fill_addr(&fill_ring, cidx + i) =
+                    *xsk_ring_cons__comp_addr(&comp_ring, comp_idx + i);
+            }
+            xsk_ring_prod__submit(&fill_ring, done);
+            xsk_ring_cons__release(&comp_ring, done);
+        }
+    }
+
+    printf("\nDPI stats: %llu packets, %llu bytes, %llu flows allowed, "
+           "%llu flows dropped\n",
+           (unsigned long long)dpi_stats.packets,
+           (unsigned long long)dpi_stats.bytes,
+           (unsigned long long)dpi_stats.flows_allowed,
+           (unsigned long long)dpi_stats.flows_dropped);
+
+    xsk_socket__delete(xsk);
+    xsk_umem__delete(umem);
+    free(umem_area);
+    return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * Firewall Control Utility
+ *
+ * Userspace companion to xdp_firewall: batch-loads CIDR blacklists
+ * into the LPM trie maps so a mitigation playbook of prefixes lands
+ * in one syscall per map instead of one insert per address.
+ *
+ * Usage:
+ *   firewall_ctl load <prefix-file>     # one CIDR per line, v4 or v6
+ *   firewall_ctl block <cidr>           # add a single prefix
+ *   firewall_ctl unblock <cidr>         # remove a single prefix
+ *
+ * The maps are expected to be pinned under /sys/fs/bpf/xdp_firewall/
+ * by the loader that attaches the XDP program.
+ *
+ * Author: Amelia Enora
+ * Date: June 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <bpf/bpf.h>
+
+#define PIN_DIR "/sys/fs/bpf/xdp_firewall"
+#define MAX_BATCH 65536
+
+// Keys must match the kernel-side map definitions in xdp_firewall.c
+struct lpm_v4_key {
+    __u32 prefixlen;
+    __u32 addr;
+};
+
+struct lpm_v6_key {
+    __u32 prefixlen;
+    __u8 addr[16];
+};
+
+// Parse "a.b.c.d/len" or "x::y/len"; bare addresses get a full-length
+// prefix. Returns AF_INET, AF_INET6, or -1 on error.
+static int parse_cidr(const char *cidr, struct lpm_v4_key *v4,
+                      struct lpm_v6_key *v6) {
+    char addr_str[INET6_ADDRSTRLEN];
+    const char *slash = strchr(cidr, '/');
+    long prefixlen = -1;
+
+    if (slash) {
+        size_t addr_len = slash - cidr;
+        if (addr_len >= sizeof(addr_str)) {
+            return -1;
+        }
+        memcpy(addr_str, cidr, addr_len);
+        addr_str[addr_len] = '\0';
+        prefixlen = strtol(slash + 1, NULL, 10);
+    } else {
+        strncpy(addr_str, cidr, sizeof(addr_str) - 1);
+        addr_str[sizeof(addr_str) - 1] = '\0';
+    }
+
+    if (inet_pton(AF_INET, addr_str, &v4->addr) == 1) {
+        v4->prefixlen = (prefixlen < 0) ? 32 : prefixlen;
+        return (v4->prefixlen <= 32) ? AF_INET : -1;
+    }
+
+    if (inet_pton(AF_INET6, addr_str, v6->addr) == 1) {
+        v6->prefixlen = (prefixlen < 0) ? 128 : prefixlen;
+        return (v6->prefixlen <= 128) ? AF_INET6 : -1;
+    }
+
+    return -1;
+}
+
+static int open_pinned_map(const char *name) {
+    char path[256];
+    snprintf(path, sizeof(path), PIN_DIR "/%s", name);
+
+    int fd = bpf_obj_get(path);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open map %s: %s\n", path, strerror(errno));
+    }
+    return fd;
+}
+
+// Load a file of prefixes and push each family to its map in one
+// bpf_map_update_batch call
+static int batch_load(const char *filename) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s: %s\n", filename, strerror(errno));
+        return 1;
+    }
+
+    static struct lpm_v4_key v4_keys[MAX_BATCH];
+    static struct lpm_v6_key v6_keys[MAX_BATCH];
+    static __u8 v4_vals[MAX_BATCH], v6_vals[MAX_BATCH];
+    __u32 num_v4 = 0, num_v6 = 0;
+
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        struct lpm_v4_key v4;
+        struct lpm_v6_key v6 = {0};
+        int family = parse_cidr(line, &v4, &v6);
+
+        if (family == AF_INET && num_v4 < MAX_BATCH) {
+            v4_keys[num_v4] = v4;
+            v4_vals[num_v4++] = 1;
+        } else if (family == AF_INET6 && num_v6 < MAX_BATCH) {
+            v6_keys[num_v6] = v6;
+            v6_vals[num_v6++] = 1;
+        } else {
+            fprintf(stderr, "Skipping invalid prefix: %s\n", line);
+        }
+    }
+    fclose(f);
+
+    int ret = 0;
+
+    if (num_v4 > 0) {
+        int fd = open_pinned_map("blacklist_lpm_v4");
+        if (fd < 0) {
+            return 1;
+        }
+        __u32 count = num_v4;
+        if (bpf_map_update_batch(fd, v4_keys, v4_vals, &count, NULL) < 0) {
+            fprintf(stderr, "v4 batch update failed after %u entries: %s\n",
+                    count, strerror(errno));
+            ret = 1;
+        } else {
+            printf("Loaded %u IPv4 prefixes\n", count);
+        }
+    }
+
+    if (num_v6 > 0) {
+        int fd = open_pinned_map("blacklist_lpm_v6");
+        if (fd < 0) {
+            return 1;
+        }
+        __u32 count = num_v6;
+        if (bpf_map_update_batch(fd, v6_keys, v6_vals, &count, NULL) < 0) {
+            fprintf(stderr, "v6 batch update failed after %u entries: %s\n",
+                    count, strerror(errno));
+            ret = 1;
+        } else {
+            printf("Loaded %u IPv6 prefixes\n", count);
+        }
+    }
+
+    return ret;
+}
+
+// Add or remove a single prefix
+static int update_one(const char *cidr, int add) {
+    struct lpm_v4_key v4;
+    struct lpm_v6_key v6 = {0};
+    int family = parse_cidr(cidr, &v4, &v6);
+
+    if (family < 0) {
+        fprintf(stderr, "Invalid prefix: %s\n", cidr);
+        return 1;
+    }
+
+    const char *map_name = (family == AF_INET) ? "blacklist_lpm_v4"
+                                               : "blacklist_lpm_v6";
+    void *key = (family == AF_INET) ? (void *)&v4 : (void *)&v6;
+
+    int fd = open_pinned_map(map_name);
+    if (fd < 0) {
+        return 1;
+    }
+
+    int err;
+    if (add) {
+        __u8 val = 1;
+        err = bpf_map_update_elem(fd, key, &val, BPF_ANY);
+    } else {
+        err = bpf_map_delete_elem(fd, key);
+    }
+
+    if (err < 0) {
+        fprintf(stderr, "%s %s failed: %s\n", add ? "block" : "unblock",
+                cidr, strerror(errno));
+        return 1;
+    }
+
+    printf("%s %s\n", add ? "Blocked" : "Unblocked", cidr);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 3 && strcmp(argv[1], "load") == 0) {
+        return batch_load(argv[2]);
+    }
+    if (argc == 3 && strcmp(argv[1], "block") == 0) {
+        return update_one(argv[2], 1);
+    }
+    if (argc == 3 && strcmp(argv[1], "unblock") == 0) {
+        return update_one(argv[2], 0);
+    }
+
+    fprintf(stderr, "Usage: %s load <prefix-file> | block <cidr> | unblock <cidr>\n",
+            argv[0]);
+    return 1;
+}
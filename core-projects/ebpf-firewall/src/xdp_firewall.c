@@ -53,6 +53,35 @@ struct {
     __uint(max_entries, 100000);
 } blacklist_map SEC(".maps");
 
+// CIDR blacklists: one LPM trie update blocks an entire prefix, so a /16
+// costs a single insert instead of 65k hash entries during mitigation.
+// Addresses are stored in network byte order (what inet_pton produces).
+struct lpm_v4_key {
+    __u32 prefixlen;
+    __u32 addr;
+};
+
+struct lpm_v6_key {
+    __u32 prefixlen;
+    __u8 addr[16];
+};
+
+struct {
+    __uint(type, BPF_MAP_TYPE_LPM_TRIE);
+    __type(key, struct lpm_v4_key);
+    __type(value, __u8);         // Block flag
+    __uint(max_entries, 65536);
+    __uint(map_flags, BPF_F_NO_PREALLOC);
+} blacklist_lpm_v4 SEC(".maps");
+
+struct {
+    __uint(type, BPF_MAP_TYPE_LPM_TRIE);
+    __type(key, struct lpm_v6_key);
+    __type(value, __u8);         // Block flag
+    __uint(max_entries, 65536);
+    __uint(map_flags, BPF_F_NO_PREALLOC);
+} blacklist_lpm_v6 SEC(".maps");
+
 struct {
     __uint(type, BPF_MAP_TYPE_ARRAY);
     __type(key, __u32);
@@ -67,6 +96,15 @@ struct {
     __uint(max_entries, 256);    // Per-CPU counters
 } counter_map SEC(".maps");
 
+// AF_XDP sockets, one per RX queue: flows flagged for deep inspection
+// are redirected here so the userspace DPI engine sees them zero-copy
+struct {
+    __uint(type, BPF_MAP_TYPE_XSKMAP);
+    __type(key, __u32);          // RX queue index
+    __type(value, __u32);        // AF_XDP socket fd
+    __uint(max_entries, 64);
+} xsk_map SEC(".maps");
+
 // Data structures
 struct connection_key {
     __u32 src_ip;
@@ -95,6 +133,7 @@ struct firewall_stats {
     __u64 malformed;
     __u64 ddos_detected;
     __u64 bytes_processed;
+    __u64 dpi_redirected;
 };
 
 // Firewall configuration
@@ -118,6 +157,14 @@ struct firewall_stats {
 #define CONN_STATE_ESTABLISHED 1
 #define CONN_STATE_CLOSING 2
 
+// DPI verdict bits in connection_state.flags (low byte holds TCP flags);
+// written by the userspace AF_XDP engine, read here on the fast path
+#define CONN_FLAG_DPI_ALLOW 0x100
+#define CONN_FLAG_DPI_DROP  0x200
+
+// Payload packets per flow sent to userspace before a verdict arrives
+#define DPI_INSPECT_PACKETS 8
+
 // Helper functions
 static __always_inline __u64 get_time_ns(void) {
     return bpf_ktime_get_ns();
@@ -183,6 +230,27 @@ static __always_inline int check_blacklist(__u32 src_ip) {
     return (blocked && *blocked) ? ACTION_DROP : ACTION_ALLOW;
 }
 
+// CIDR blacklist check (takes saddr in network byte order)
+static __always_inline int check_blacklist_lpm_v4(__u32 saddr) {
+    struct lpm_v4_key key = {
+        .prefixlen = 32,
+        .addr = saddr
+    };
+
+    __u8 *blocked = bpf_map_lookup_elem(&blacklist_lpm_v4, &key);
+    return (blocked && *blocked) ? ACTION_DROP : ACTION_ALLOW;
+}
+
+static __always_inline int check_blacklist_lpm_v6(struct in6_addr *saddr) {
+    struct lpm_v6_key key = {
+        .prefixlen = 128
+    };
+    __builtin_memcpy(key.addr, saddr, 16);
+
+    __u8 *blocked = bpf_map_lookup_elem(&blacklist_lpm_v6, &key);
+    return (blocked && *blocked) ? ACTION_DROP : ACTION_ALLOW;
+}
+
 // DDoS detection using SYN flood detection
 static __always_inline int detect_ddos(struct tcphdr *tcp, __u32 src_ip) {
     if (!(tcp->syn && !tcp->ack)) {
@@ -207,12 +275,12 @@ static __always_inline int detect_ddos(struct tcphdr *tcp, __u32 src_ip) {
     return ACTION_ALLOW;
 }
 
-// Connection tracking
-static __always_inline int track_connection(struct connection_key *key,
-                                          __u32 packet_len, __u8 tcp_flags) {
+// Connection tracking; returns the tracked state (NULL if just created)
+static __always_inline struct connection_state *
+track_connection(struct connection_key *key, __u32 packet_len, __u8 tcp_flags) {
     __u64 current_time = get_time_ns();
     struct connection_state *conn = bpf_map_lookup_elem(&connection_map, key);
-    
+
     if (!conn) {
         // New connection
         struct connection_state new_conn = {
@@ -223,9 +291,9 @@ static __always_inline int track_connection(struct connection_key *key,
             .state = CONN_STATE_NEW,
             .flags = tcp_flags
         };
-        
+
         bpf_map_update_elem(&connection_map, key, &new_conn, BPF_ANY);
-        return ACTION_ALLOW;
+        return NULL;
     }
     
     // Update existing connection
@@ -245,7 +313,7 @@ static __always_inline int track_connection(struct connection_key *key,
     }
     
     bpf_map_update_elem(&connection_map, key, conn, BPF_ANY);
-    return ACTION_ALLOW;
+    return conn;
 }
 
 // Deep packet inspection for malicious patterns
@@ -329,6 +397,24 @@ int xdp_firewall_main(struct xdp_md *ctx) {
         return XDP_DROP;
     }
     
+    // IPv6: CIDR blacklist only, rest of the pipeline is IPv4
+    if (eth->h_proto == bpf_htons(ETH_P_IPV6)) {
+        struct ipv6hdr *ip6 = (void *)(eth + 1);
+        if ((void *)(ip6 + 1) > data_end) {
+            update_stats(stats, ctx->data_end - ctx->data, ACTION_DROP);
+            return XDP_DROP;
+        }
+
+        if (check_blacklist_lpm_v6(&ip6->saddr) == ACTION_DROP) {
+            __sync_fetch_and_add(&stats->blacklisted, 1);
+            update_stats(stats, ctx->data_end - ctx->data, ACTION_DROP);
+            return XDP_DROP;
+        }
+
+        update_stats(stats, ctx->data_end - ctx->data, ACTION_ALLOW);
+        return XDP_PASS;
+    }
+
     // Only process IPv4 packets
     if (eth->h_proto != bpf_htons(ETH_P_IP)) {
         update_stats(stats, ctx->data_end - ctx->data, ACTION_ALLOW);
@@ -353,7 +439,14 @@ int xdp_firewall_main(struct xdp_md *ctx) {
     __u32 dst_ip = bpf_ntohl(ip->daddr);
     __u32 packet_len = ctx->data_end - ctx->data;
     
-    // Check blacklist
+    // Check CIDR blacklist first: one trie entry covers a whole prefix
+    if (check_blacklist_lpm_v4(ip->saddr) == ACTION_DROP) {
+        __sync_fetch_and_add(&stats->blacklisted, 1);
+        update_stats(stats, packet_len, ACTION_DROP);
+        return XDP_DROP;
+    }
+
+    // Check per-IP blacklist
     if (check_blacklist(src_ip) == ACTION_DROP) {
         __sync_fetch_and_add(&stats->blacklisted, 1);
         update_stats(stats, packet_len, ACTION_DROP);
@@ -404,9 +497,17 @@ int xdp_firewall_main(struct xdp_md *ctx) {
             .protocol = IPPROTO_TCP
         };
         
-        track_connection(&conn_key, packet_len, 
+        struct connection_state *conn =
+            track_connection(&conn_key, packet_len,
                         tcp->syn | (tcp->ack << 1) | (tcp->fin << 2));
-        
+
+        // Enforce a verdict the userspace DPI engine already delivered
+        __u32 dpi_flags = conn ? conn->flags : 0;
+        if (dpi_flags & CONN_FLAG_DPI_DROP) {
+            update_stats(stats, packet_len, ACTION_DROP);
+            return XDP_DROP;
+        }
+
         // Deep packet inspection on TCP payload
         void *tcp_payload = (void *)tcp + (tcp->doff * 4);
         if (tcp_payload < data_end) {
@@ -414,8 +515,18 @@ int xdp_firewall_main(struct xdp_md *ctx) {
                 update_stats(stats, packet_len, ACTION_DROP);
                 return XDP_DROP;
             }
+
+            // Early payload of an unverdicted flow: hand it to the
+            // AF_XDP engine for full inspection. Falls through to
+            // XDP_PASS if no socket is bound to this queue.
+            if (!(dpi_flags & CONN_FLAG_DPI_ALLOW) &&
+                (!conn || conn->packets <= DPI_INSPECT_PACKETS)) {
+                __sync_fetch_and_add(&stats->dpi_redirected, 1);
+                update_stats(stats, packet_len, ACTION_ALLOW);
+                return bpf_redirect_map(&xsk_map, ctx->rx_queue_index, XDP_PASS);
+            }
         }
-        
+
     } else if (ip->protocol == IPPROTO_UDP) {
         struct udphdr *udp = l4_header;
         if ((void *)(udp + 1) > data_end) {
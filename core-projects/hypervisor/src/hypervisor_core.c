@@ -40,6 +40,28 @@
 #define VMCS_GUEST_CR4               0x6804
 #define VMCS_VM_EXIT_CONTROLS        0x400C
 #define VMCS_VM_ENTRY_CONTROLS       0x4012
+#define VMCS_PIN_BASED_CONTROLS      0x4000
+#define VMCS_PRIMARY_PROC_CONTROLS   0x4002
+#define VMCS_SECONDARY_PROC_CONTROLS 0x401E
+#define VMCS_POSTED_INTR_VECTOR      0x0002
+#define VMCS_POSTED_INTR_DESC_ADDR   0x2016
+
+// Pin-based / secondary execution control bits for posted interrupts
+#define PIN_CTRL_EXT_INTR_EXIT       (1 << 0)
+#define PIN_CTRL_POSTED_INTR         (1 << 7)
+#define PROC_CTRL_SECONDARY          (1U << 31)
+#define SEC_CTRL_VIRT_INTR_DELIVERY  (1 << 9)
+
+// Vector used for posted-interrupt notification IPIs
+#define POSTED_INTR_NOTIFY_VECTOR    0xF2
+
+// x2APIC interrupt command register
+#define MSR_X2APIC_ICR               0x830
+
+// Scheduling
+#define MAX_PCPUS                    64
+#define VCPU_AFFINITY_ANY            (-1)
+#define SCHED_TIMESLICE_ENTRIES      1024
 
 // VM exit reasons
 #define EXIT_REASON_CPUID            10
@@ -55,38 +77,69 @@ typedef struct {
     bool vpid_supported;
     bool unrestricted_guest;
     bool secondary_controls;
+    bool posted_interrupts;
     uint64_t vmx_basic;
 } cpu_caps_t;
 
+// Posted-interrupt descriptor (Intel SDM 29.6): the CPU reads this
+// while the guest runs, so device interrupts accumulated in the PIR
+// are delivered without a VM exit
+typedef struct {
+    uint32_t pir[8];        // Posted-interrupt requests, one bit per vector
+    uint32_t control;       // Bit 0: outstanding notification (ON)
+    uint32_t reserved[7];
+} __attribute__((aligned(64))) posted_intr_desc_t;
+
+#define PI_DESC_ON 1
+
 // Virtual CPU state
 typedef struct vcpu {
     uint64_t vmcs_region;
     uint64_t vmx_on_region;
     bool vmx_on;
     bool vmcs_loaded;
-    
+
     // Guest state
     uint64_t guest_rip;
     uint64_t guest_rsp;
     uint64_t guest_cr0;
     uint64_t guest_cr3;
     uint64_t guest_cr4;
-    
+
     // Host state
     uint64_t host_rip;
     uint64_t host_rsp;
     uint64_t host_cr0;
     uint64_t host_cr3;
     uint64_t host_cr4;
-    
+
+    // Scheduling
+    struct vm *vm;
+    uint32_t pcpu;          // Physical core this vCPU runs on
+    int32_t affinity;       // Pinned core, or VCPU_AFFINITY_ANY
+    volatile bool running;  // Currently inside the entry/exit loop
+    struct vcpu *runq_next;
+
+    // Posted interrupts
+    posted_intr_desc_t pi_desc;
+
     // Statistics
     uint64_t vm_exits;
     uint64_t vm_entries;
     uint64_t total_cycles;
-    
+    uint64_t posted_intrs;
+
     struct vcpu *next;
 } vcpu_t;
 
+// Per-physical-core run queue of ready vCPUs
+typedef struct {
+    vcpu_t *head;
+    vcpu_t *tail;
+    uint32_t num_vcpus;
+    uint64_t switches;
+} pcpu_runqueue_t;
+
 // Virtual machine
 typedef struct vm {
     uint32_t vm_id;
@@ -114,6 +167,10 @@ typedef struct hypervisor {
     uint32_t num_vms;
     uint64_t total_memory;
     uint64_t used_memory;
+
+    // Per-core scheduling
+    pcpu_runqueue_t runqueues[MAX_PCPUS];
+    uint32_t num_pcpus;
 } hypervisor_t;
 
 static hypervisor_t g_hypervisor;
@@ -211,6 +268,104 @@ static void init_cpu_caps(void) {
     g_hypervisor.cpu_caps.ept_supported = true;
     g_hypervisor.cpu_caps.vpid_supported = true;
     g_hypervisor.cpu_caps.unrestricted_guest = true;
+    g_hypervisor.cpu_caps.posted_interrupts = g_hypervisor.cpu_caps.secondary_controls;
+
+    // Logical processor count (simplified)
+    g_hypervisor.num_pcpus = (ebx >> 16) & 0xFF;
+    if (g_hypervisor.num_pcpus == 0) {
+        g_hypervisor.num_pcpus = 1;
+    }
+    if (g_hypervisor.num_pcpus > MAX_PCPUS) {
+        g_hypervisor.num_pcpus = MAX_PCPUS;
+    }
+}
+
+// Index of the core we're running on (initial APIC ID; we assume the
+// simple case where APIC IDs are dense and equal to the core index)
+static uint32_t current_pcpu(void) {
+    uint32_t eax, ebx, ecx, edx;
+    __asm__ volatile ("cpuid"
+                     : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                     : "a"(1));
+    return (ebx >> 24) % MAX_PCPUS;
+}
+
+// Per-core run queues
+static void runqueue_enqueue(uint32_t pcpu, vcpu_t *vcpu) {
+    pcpu_runqueue_t *rq = &g_hypervisor.runqueues[pcpu];
+
+    vcpu->pcpu = pcpu;
+    vcpu->runq_next = NULL;
+
+    if (rq->tail) {
+        rq->tail->runq_next = vcpu;
+    } else {
+        rq->head = vcpu;
+    }
+    rq->tail = vcpu;
+    rq->num_vcpus++;
+}
+
+static vcpu_t *runqueue_pick(uint32_t pcpu) {
+    pcpu_runqueue_t *rq = &g_hypervisor.runqueues[pcpu];
+    vcpu_t *vcpu = rq->head;
+
+    if (!vcpu) {
+        return NULL;
+    }
+
+    rq->head = vcpu->runq_next;
+    if (!rq->head) {
+        rq->tail = NULL;
+    }
+    rq->num_vcpus--;
+    rq->switches++;
+
+    vcpu->runq_next = NULL;
+    return vcpu;
+}
+
+// Choose a core for a vCPU: honor pinning, otherwise least loaded
+static uint32_t pick_pcpu(vcpu_t *vcpu) {
+    if (vcpu->affinity != VCPU_AFFINITY_ANY) {
+        return (uint32_t)vcpu->affinity % g_hypervisor.num_pcpus;
+    }
+
+    uint32_t best = 0;
+    for (uint32_t i = 1; i < g_hypervisor.num_pcpus; i++) {
+        if (g_hypervisor.runqueues[i].num_vcpus <
+            g_hypervisor.runqueues[best].num_vcpus) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Pin a vCPU to a physical core; takes effect at its next reschedule
+void set_vcpu_affinity(vcpu_t *vcpu, int32_t pcpu) {
+    vcpu->affinity = pcpu;
+}
+
+// Post a device interrupt to a vCPU. Sets the vector in the PIR and,
+// if the vCPU is in guest mode, sends the notification IPI so the CPU
+// delivers it directly through the virtual APIC -- no VM exit.
+void post_interrupt(vcpu_t *vcpu, uint8_t vector) {
+    __sync_fetch_and_or(&vcpu->pi_desc.pir[vector >> 5], 1U << (vector & 31));
+
+    // If a notification is already outstanding the CPU will pick this
+    // vector up with it
+    if (__sync_fetch_and_or(&vcpu->pi_desc.control, PI_DESC_ON) & PI_DESC_ON) {
+        return;
+    }
+
+    vcpu->posted_intrs++;
+
+    if (vcpu->running) {
+        // x2APIC fixed IPI to the core running the guest
+        write_msr_inline(MSR_X2APIC_ICR,
+                        ((uint64_t)vcpu->pcpu << 32) | POSTED_INTR_NOTIFY_VECTOR);
+    }
+    // Otherwise the PIR is synced on the vCPU's next VM entry
 }
 
 // Allocate aligned memory for VMCS/VMXON regions
@@ -323,6 +478,18 @@ static bool setup_vmcs(vcpu_t *vcpu, vm_t *vm) {
     // Setup VM execution controls
     vmwrite(VMCS_VM_EXIT_CONTROLS, 0x36DFF); // Basic exit controls
     vmwrite(VMCS_VM_ENTRY_CONTROLS, 0x13FF); // Basic entry controls
+
+    // Posted-interrupt processing: interrupts posted to the PI
+    // descriptor are delivered through the virtual APIC while the
+    // guest runs, instead of forcing an external-interrupt exit
+    if (g_hypervisor.cpu_caps.posted_interrupts) {
+        vmwrite(VMCS_PIN_BASED_CONTROLS,
+                PIN_CTRL_EXT_INTR_EXIT | PIN_CTRL_POSTED_INTR);
+        vmwrite(VMCS_PRIMARY_PROC_CONTROLS, PROC_CTRL_SECONDARY);
+        vmwrite(VMCS_SECONDARY_PROC_CONTROLS, SEC_CTRL_VIRT_INTR_DELIVERY);
+        vmwrite(VMCS_POSTED_INTR_VECTOR, POSTED_INTR_NOTIFY_VECTOR);
+        vmwrite(VMCS_POSTED_INTR_DESC_ADDR, (uint64_t)&vcpu->pi_desc);
+    }
     
     // Setup EPT pointer
     uint64_t *ept_pml4 = setup_ept(vm->guest_memory_base, vm->guest_memory_size);
@@ -433,6 +600,8 @@ vm_t *create_vm(const char *name, uint64_t memory_size) {
     }
     
     memset(vcpu, 0, sizeof(vcpu_t));
+    vcpu->vm = vm;
+    vcpu->affinity = VCPU_AFFINITY_ANY;
     vm->vcpus = vcpu;
     vm->num_vcpus = 1;
     
@@ -460,25 +629,32 @@ bool start_vm(vm_t *vm) {
     if (!setup_vmcs(vcpu, vm)) {
         return false;
     }
-    
+
     vm->started = true;
     vm->paused = false;
-    
+
+    // Place each vCPU on a run queue
+    for (vcpu_t *v = vm->vcpus; v; v = v->next) {
+        runqueue_enqueue(pick_pcpu(v), v);
+    }
+
     return true;
 }
 
-// Run virtual machine
-void run_vm(vm_t *vm) {
-    if (!vm || !vm->started || vm->paused) {
+// Run one vCPU for a timeslice of VM entries
+static void run_vcpu_slice(vcpu_t *vcpu, vm_t *vm) {
+    // Make this vCPU's VMCS current on this core
+    if (!vmptrld(vcpu->vmcs_region)) {
+        vm->paused = true;
         return;
     }
-    
-    vcpu_t *vcpu = vm->vcpus;
-    
-    // VM entry/exit loop
-    while (!vm->paused) {
+
+    vcpu->running = true;
+
+    for (uint32_t slice = 0; slice < SCHED_TIMESLICE_ENTRIES && !vm->paused;
+         slice++) {
         uint64_t start_cycles = __rdtsc();
-        
+
         // Launch or resume VM
         bool success;
         if (vcpu->vm_entries == 0) {
@@ -486,20 +662,57 @@ void run_vm(vm_t *vm) {
         } else {
             success = vmresume();
         }
-        
+
         if (!success) {
             vm->paused = true;
             break;
         }
-        
+
         vcpu->vm_entries++;
-        
+
         // Handle VM exit
         handle_vm_exit(vcpu, vm);
-        
+
         uint64_t end_cycles = __rdtsc();
         vcpu->total_cycles += end_cycles - start_cycles;
     }
+
+    vcpu->running = false;
+}
+
+// Per-core scheduler: rotate through this core's run queue until it
+// drains. Each core calls this on its own queue, so no cross-core
+// locking is needed and vCPUs keep their cache-warm home core.
+void run_pcpu(uint32_t pcpu) {
+    pcpu_runqueue_t *rq = &g_hypervisor.runqueues[pcpu % MAX_PCPUS];
+
+    while (rq->num_vcpus > 0) {
+        vcpu_t *vcpu = runqueue_pick(pcpu % MAX_PCPUS);
+        if (!vcpu) {
+            break;
+        }
+
+        vm_t *vm = vcpu->vm;
+        if (!vm->started || vm->paused) {
+            continue;  // Drop finished vCPUs from the queue
+        }
+
+        run_vcpu_slice(vcpu, vm);
+
+        if (vm->started && !vm->paused) {
+            // Re-queue, honoring any affinity change made meanwhile
+            runqueue_enqueue(pick_pcpu(vcpu), vcpu);
+        }
+    }
+}
+
+// Run virtual machine (drives the scheduler of the calling core)
+void run_vm(vm_t *vm) {
+    if (!vm || !vm->started || vm->paused) {
+        return;
+    }
+
+    run_pcpu(current_pcpu() % g_hypervisor.num_pcpus);
 }
 
 // Stop virtual machine
@@ -530,6 +743,9 @@ void get_vm_stats(vm_t *vm) {
     printf("vCPUs: %u\n", vm->num_vcpus);
     printf("VM Exits: %lu\n", vcpu->vm_exits);
     printf("VM Entries: %lu\n", vcpu->vm_entries);
+    printf("Posted interrupts: %lu\n", vcpu->posted_intrs);
+    printf("Home core: %u%s\n", vcpu->pcpu,
+           vcpu->affinity != VCPU_AFFINITY_ANY ? " (pinned)" : "");
     
     if (vcpu->vm_exits > 0) {
         double avg_cycles = (double)vcpu->total_cycles / vcpu->vm_exits;
@@ -562,6 +778,8 @@ bool init_hypervisor(void) {
     printf("EPT: %s\n", g_hypervisor.cpu_caps.ept_supported ? "Yes" : "No");
     printf("VPID: %s\n", g_hypervisor.cpu_caps.vpid_supported ? "Yes" : "No");
     printf("Unrestricted Guest: %s\n", g_hypervisor.cpu_caps.unrestricted_guest ? "Yes" : "No");
+    printf("Posted Interrupts: %s\n", g_hypervisor.cpu_caps.posted_interrupts ? "Yes" : "No");
+    printf("Physical cores: %u\n", g_hypervisor.num_pcpus);
     
     return true;
 }
@@ -23,6 +23,8 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
 
 // JIT Architecture types
 typedef enum {
@@ -52,7 +54,13 @@ typedef enum {
     JIT_OP_BRANCH,
     JIT_OP_BRANCH_IF,
     JIT_OP_CALL,
-    JIT_OP_RETURN
+    JIT_OP_RETURN,
+    // Packed (SIMD) forms emitted by the loop vectorizer
+    JIT_OP_VADD,
+    JIT_OP_VSUB,
+    JIT_OP_VMUL,
+    JIT_OP_VLOAD,
+    JIT_OP_VSTORE
 } jit_opcode_t;
 
 // Forward declarations
@@ -79,6 +87,7 @@ struct jit_instruction {
     jit_block_t *else_block;
     jit_instruction_t *next;
     int is_live;
+    int vector_width;   // lanes per packed op, 0 for scalar
 };
 
 // Basic Block
@@ -98,19 +107,27 @@ typedef struct {
 } physical_reg_t;
 
 typedef struct {
-    int physical_reg;
+    int physical_reg;   // hardware encoding, or -1
     int spilled;
-    int start_pos;
+    int stack_slot;     // valid when spilled
+    int start_pos;      // live interval, linear instruction numbering
     int end_pos;
 } virtual_reg_t;
 
 typedef struct {
-    virtual_reg_t *virtual_regs;
+    virtual_reg_t *virtual_regs;    // indexed by SSA id
     physical_reg_t *physical_regs;
     int num_virtual_regs;
     int num_physical_regs;
+    int num_stack_slots;            // spill slots needed in the frame
 } reg_allocator_t;
 
+// Compilation tiers
+typedef enum {
+    JIT_TIER_BASELINE,   // fast single-pass compile, plants call counters
+    JIT_TIER_OPTIMIZED   // full pipeline, installed by the tier monitor
+} jit_tier_t;
+
 // JIT Function
 struct jit_function {
     jit_block_t *entry_block;
@@ -118,6 +135,8 @@ struct jit_function {
     uint32_t num_blocks;
     uint32_t next_ssa_id;
     reg_allocator_t reg_allocator;
+    jit_tier_t tier;
+    uint64_t call_count;   // bumped by the baseline-tier prologue
 };
 
 // JIT Context
@@ -127,6 +146,7 @@ typedef struct {
     void *code_ptr;
     size_t code_cache_size;
     int initialized;
+    int has_avx2;
 } jit_context_t;
 
 // Constants
@@ -191,6 +211,9 @@ int jit_init(jit_arch_t target_arch) {
     
     g_jit_context.target_arch = target_arch;
     g_jit_context.code_cache_size = JIT_CODE_CACHE_SIZE;
+#if defined(__x86_64__)
+    g_jit_context.has_avx2 = __builtin_cpu_supports("avx2");
+#endif
     
     // Allocate executable memory for code cache
     g_jit_context.code_cache = mmap(NULL, g_jit_context.code_cache_size,
@@ -430,54 +453,624 @@ static void constant_folding(jit_function_t *func) {
     }
 }
 
+// Loop auto-vectorization
+//
+// Countable single-block loops (a block whose terminating BRANCH_IF
+// targets itself) with independent element-wise bodies are rewritten to
+// process `width` int32 lanes per trip using the packed opcodes. The IR
+// has no compare op — the guard is a countdown tested by
+// branch-if-nonzero — so a runtime `remaining >= width` preheader check
+// cannot be expressed. The guard is therefore resolved at compile time:
+// the counter's initial value must be a known constant, the packed copy
+// covers the largest multiple of `width` iterations, and any remainder
+// runs in a scalar tail whose counter is re-seeded to exactly the
+// leftover count. Loops with an unknown trip count, or shorter than one
+// packed trip, stay scalar. Only the induction update and the address
+// bumps are scaled by the lane count; other constant arithmetic in the
+// body is already per-element and is left untouched.
+
+static int block_is_vectorizable(jit_block_t *block) {
+    int loads = 0, stores = 0;
+    jit_instruction_t *inst = block->instructions;
+    while (inst) {
+        switch (inst->opcode) {
+            case JIT_OP_LOAD:
+                loads++;
+                break;
+            case JIT_OP_STORE:
+                stores++;
+                break;
+            case JIT_OP_ADD:
+            case JIT_OP_SUB:
+            case JIT_OP_MUL:
+            case JIT_OP_MOV:
+                break;
+            case JIT_OP_BRANCH_IF:
+                // Only as the back-edge terminator
+                if (inst->next || inst->target_block != block) return 0;
+                break;
+            default:
+                return 0;  // DIV, CALL, nested control flow stay scalar
+        }
+        inst = inst->next;
+    }
+    return loads > 0 && stores > 0;
+}
+
+// Last constant MOV writing `id` before `loop` begins; NULL when any
+// instruction on the way clobbers it with something we can't evaluate
+static jit_instruction_t *find_counter_init(jit_function_t *func,
+                                            jit_block_t *loop, uint32_t id) {
+    jit_instruction_t *def = NULL;
+    for (jit_block_t *b = func->entry_block; b && b != loop; b = b->next) {
+        for (jit_instruction_t *i = b->instructions; i; i = i->next) {
+            if (i->opcode == JIT_OP_MOV && i->dest.id == id &&
+                i->src1.is_constant) {
+                def = i;
+            } else if (i->dest.id == id) {
+                def = NULL;
+            }
+        }
+    }
+    return def;
+}
+
+// True when `id` is used as a memory address somewhere in the loop body
+static int feeds_memory_address(jit_block_t *block, uint32_t id) {
+    for (jit_instruction_t *i = block->instructions; i; i = i->next) {
+        switch (i->opcode) {
+            case JIT_OP_LOAD:
+            case JIT_OP_STORE:
+            case JIT_OP_VLOAD:
+            case JIT_OP_VSTORE:
+                if (!i->src1.is_constant && i->src1.id == id) {
+                    return 1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return 0;
+}
+
+static void vectorize_loops(jit_function_t *func, int width) {
+    if (width <= 1) return;
+
+    jit_block_t *block = func->entry_block;
+    while (block) {
+        jit_instruction_t *term = block->last_instruction;
+        if (!term || term->opcode != JIT_OP_BRANCH_IF ||
+            term->target_block != block || !block_is_vectorizable(block)) {
+            block = block->next;
+            continue;
+        }
+
+        // The guard countdown: a SUB by a constant step whose result
+        // the terminator tests
+        jit_instruction_t *induction = NULL;
+        for (jit_instruction_t *inst = block->instructions; inst != term;
+             inst = inst->next) {
+            if (inst->dest.id == term->src1.id) {
+                induction = inst;
+            }
+        }
+        if (!induction || induction->opcode != JIT_OP_SUB ||
+            induction->src1.is_constant || !induction->src2.is_constant ||
+            induction->src2.constant_value <= 0) {
+            block = block->next;
+            continue;
+        }
+        int64_t step = induction->src2.constant_value;
+
+        // Compile-time preheader guard: the counter's start value must
+        // be a known constant, or the trip count can't be proven
+        jit_instruction_t *init =
+            find_counter_init(func, block, induction->src1.id);
+        if (!init || init->src1.constant_value <= 0 ||
+            init->src1.constant_value % step != 0) {
+            block = block->next;
+            continue;
+        }
+        int64_t trips = init->src1.constant_value / step;
+        int64_t remainder = trips % width;
+        if (trips < width) {
+            block = block->next;  // shorter than one packed trip
+            continue;
+        }
+
+        // Scalar tail for the remainder: a copy of the loop, looping on
+        // itself, entered with the counter re-seeded to exactly the
+        // leftover iterations. Address registers simply continue from
+        // where the packed copy leaves them. An exact multiple needs no
+        // tail at all.
+        if (remainder > 0) {
+            init->src1.constant_value = (trips - remainder) * step;
+
+            jit_block_t *tail = jit_block_create();
+            jit_instruction_t *reseed = calloc(1, sizeof(jit_instruction_t));
+            reseed->opcode = JIT_OP_MOV;
+            reseed->dest = induction->src1;
+            reseed->src1 = jit_value_create_constant(func, induction->src1.type,
+                                                     remainder * step);
+            tail->instructions = reseed;
+            tail->last_instruction = reseed;
+            tail->num_instructions = 1;
+
+            for (jit_instruction_t *inst = block->instructions; inst;
+                 inst = inst->next) {
+                jit_instruction_t *copy = calloc(1, sizeof(jit_instruction_t));
+                *copy = *inst;
+                copy->next = NULL;
+                if (copy->opcode == JIT_OP_BRANCH_IF) {
+                    copy->target_block = tail;
+                }
+                tail->last_instruction->next = copy;
+                tail->last_instruction = copy;
+                tail->num_instructions++;
+            }
+            tail->next = block->next;
+            block->next = tail;
+            func->num_blocks++;
+
+            // Exiting the packed loop falls into the tail
+            term->else_block = tail;
+        }
+
+        // Hot copy goes packed
+        for (jit_instruction_t *inst = block->instructions; inst; inst = inst->next) {
+            switch (inst->opcode) {
+                case JIT_OP_LOAD:
+                    inst->opcode = JIT_OP_VLOAD;
+                    inst->vector_width = width;
+                    break;
+                case JIT_OP_STORE:
+                    inst->opcode = JIT_OP_VSTORE;
+                    inst->vector_width = width;
+                    break;
+                case JIT_OP_ADD:
+                case JIT_OP_SUB:
+                case JIT_OP_MUL:
+                    if (inst == induction) {
+                        // The counter retires a full vector per trip
+                        inst->src2.constant_value *= width;
+                    } else if (inst->src2.is_constant &&
+                               feeds_memory_address(block, inst->dest.id)) {
+                        // Address bump: a full vector of elements
+                        inst->src2.constant_value *= width;
+                    } else if (!inst->src2.is_constant) {
+                        if (inst->opcode == JIT_OP_ADD) inst->opcode = JIT_OP_VADD;
+                        else if (inst->opcode == JIT_OP_SUB) inst->opcode = JIT_OP_VSUB;
+                        else inst->opcode = JIT_OP_VMUL;
+                        inst->vector_width = width;
+                    }
+                    // Constant arithmetic that is neither (x = y * 2)
+                    // is already per-element and keeps its constant
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Don't re-visit the tail we may have just built
+        block = (remainder > 0) ? block->next->next : block->next;
+    }
+}
+
+// Linear-scan register allocation
+//
+// Values get live intervals from one linear numbering pass over the
+// blocks, then the classic Poletto/Sarkar scan hands out registers from
+// the arch's allocatable set and spills the interval that ends furthest
+// away when the set is exhausted. Two registers per arch are reserved as
+// codegen scratch for spilled/constant operands.
+
+// rax, rcx, rdx, rsi, rdi, r8, r9: all caller-saved. rbp/rsp are the
+// frame, r10/r11 are codegen scratch, and rbx stays out because the
+// prologue doesn't save callee-saved registers.
+static const int x86_64_alloc_regs[] = {0, 2, 3, 4, 5, 8, 9};
+static const int arm64_alloc_regs[]  = {0, 1, 2, 3, 4, 5, 6, 7, 8, 11, 12, 13, 14, 15}; // x9/x10 scratch
+static const int riscv_alloc_regs[]  = {10, 11, 12, 13, 14, 15, 16, 17, 5, 6, 7, 28, 29}; // t5/t6 scratch
+
+typedef struct {
+    int vreg;
+    int start;
+    int end;
+} live_interval_t;
+
+static void record_use(virtual_reg_t *regs, const jit_value_t *value, int pos) {
+    if (value->id == 0 || value->is_constant) return;
+    virtual_reg_t *reg = &regs[value->id];
+    if (reg->start_pos < 0) reg->start_pos = pos;
+    if (pos > reg->end_pos) reg->end_pos = pos;
+}
+
+static int interval_start_cmp(const void *a, const void *b) {
+    return ((const live_interval_t*)a)->start - ((const live_interval_t*)b)->start;
+}
+
+static void linear_scan_allocate(jit_function_t *func,
+                                 const int *alloc_regs, int num_alloc_regs) {
+    int num_values = (int)func->next_ssa_id;
+
+    free(func->reg_allocator.virtual_regs);
+    virtual_reg_t *vregs = calloc(num_values, sizeof(virtual_reg_t));
+    for (int i = 0; i < num_values; i++) {
+        vregs[i].physical_reg = -1;
+        vregs[i].start_pos = -1;
+        vregs[i].end_pos = -1;
+    }
+
+    // 1) Linear numbering + live interval computation
+    int pos = 0;
+    jit_block_t *block = func->entry_block;
+    while (block) {
+        jit_instruction_t *inst = block->instructions;
+        while (inst) {
+            record_use(vregs, &inst->src1, pos);
+            record_use(vregs, &inst->src2, pos);
+            record_use(vregs, &inst->dest, pos);
+            pos++;
+            inst = inst->next;
+        }
+        block = block->next;
+    }
+
+    // 2) Collect and sort intervals by start
+    int num_intervals = 0;
+    live_interval_t *intervals = malloc(num_values * sizeof(live_interval_t));
+    for (int i = 1; i < num_values; i++) {
+        if (vregs[i].start_pos >= 0) {
+            intervals[num_intervals].vreg = i;
+            intervals[num_intervals].start = vregs[i].start_pos;
+            intervals[num_intervals].end = vregs[i].end_pos;
+            num_intervals++;
+        }
+    }
+    qsort(intervals, num_intervals, sizeof(live_interval_t), interval_start_cmp);
+
+    // 3) The scan: `active` holds vregs currently owning a register
+    int *active = malloc(num_alloc_regs * sizeof(int));
+    int num_active = 0;
+    int num_stack_slots = 0;
+
+    for (int i = 0; i < num_intervals; i++) {
+        live_interval_t *iv = &intervals[i];
+
+        // Expire intervals that ended before this one starts
+        for (int a = 0; a < num_active; ) {
+            if (vregs[active[a]].end_pos < iv->start) {
+                active[a] = active[--num_active];
+            } else {
+                a++;
+            }
+        }
+
+        if (num_active < num_alloc_regs) {
+            // Pick a register no active interval is using
+            for (int r = 0; r < num_alloc_regs; r++) {
+                int taken = 0;
+                for (int a = 0; a < num_active; a++) {
+                    if (vregs[active[a]].physical_reg == alloc_regs[r]) {
+                        taken = 1;
+                        break;
+                    }
+                }
+                if (!taken) {
+                    vregs[iv->vreg].physical_reg = alloc_regs[r];
+                    break;
+                }
+            }
+            active[num_active++] = iv->vreg;
+        } else {
+            // Spill whichever interval ends last - it blocks a register
+            // for the longest time
+            int victim_idx = 0;
+            for (int a = 1; a < num_active; a++) {
+                if (vregs[active[a]].end_pos > vregs[active[victim_idx]].end_pos) {
+                    victim_idx = a;
+                }
+            }
+            int victim = active[victim_idx];
+
+            if (vregs[victim].end_pos > iv->end) {
+                // Steal the victim's register, spill the victim
+                vregs[iv->vreg].physical_reg = vregs[victim].physical_reg;
+                vregs[victim].physical_reg = -1;
+                vregs[victim].spilled = 1;
+                vregs[victim].stack_slot = num_stack_slots++;
+                active[victim_idx] = iv->vreg;
+            } else {
+                vregs[iv->vreg].spilled = 1;
+                vregs[iv->vreg].stack_slot = num_stack_slots++;
+            }
+        }
+    }
+
+    free(active);
+    free(intervals);
+
+    func->reg_allocator.virtual_regs = vregs;
+    func->reg_allocator.num_virtual_regs = num_values;
+    func->reg_allocator.num_stack_slots = num_stack_slots;
+}
+
+// Branch fixups
+//
+// Blocks are lowered in list order, so a branch may reference a block
+// whose code offset is not known yet. Each backend emits branches with a
+// zero displacement, records a fixup, and patches the displacement in
+// once the block walk has assigned every block its offset. `patch_at` is
+// a byte offset on x86_64 and an instruction index on ARM64/RISC-V.
+
+typedef struct {
+    size_t patch_at;
+    jit_block_t *target;
+} branch_fixup_t;
+
+// Worst case is one fixup per BRANCH plus two per BRANCH_IF (the
+// conditional jump and a possible jump to the else block)
+static size_t count_branch_fixups(jit_function_t *func) {
+    size_t count = 0;
+    for (jit_block_t *b = func->entry_block; b; b = b->next) {
+        for (jit_instruction_t *i = b->instructions; i; i = i->next) {
+            if (i->opcode == JIT_OP_BRANCH) count++;
+            else if (i->opcode == JIT_OP_BRANCH_IF) count += 2;
+        }
+    }
+    return count;
+}
+
+// Code offset of `target` once the block walk has recorded every block.
+// A target outside the function falls back to the entry at offset 0.
+static size_t branch_target_offset(jit_block_t **blocks, const size_t *offsets,
+                                   size_t count, const jit_block_t *target) {
+    for (size_t i = 0; i < count; i++) {
+        if (blocks[i] == target) return offsets[i];
+    }
+    return 0;
+}
+
 // x86_64 code generation
+//
+// Three-address IR maps onto two-address x86 as: mov dst, src1; op dst,
+// src2. Operands that are constants or spilled are materialized into the
+// reserved scratch registers r10/r11 first.
+
+#define X86_SCRATCH0 10  // r10
+#define X86_SCRATCH1 11  // r11
+
+static uint8_t *x86_emit_rr(uint8_t *code, uint8_t opcode, int reg, int rm) {
+    *code++ = 0x48 | ((reg >= 8) << 2) | (rm >= 8);       // REX.W
+    *code++ = opcode;
+    *code++ = 0xc0 | ((reg & 7) << 3) | (rm & 7);         // ModRM reg,rm
+    return code;
+}
+
+static uint8_t *x86_emit_imul_rr(uint8_t *code, int reg, int rm) {
+    *code++ = 0x48 | ((reg >= 8) << 2) | (rm >= 8);
+    *code++ = 0x0f; *code++ = 0xaf;                        // imul reg, rm
+    *code++ = 0xc0 | ((reg & 7) << 3) | (rm & 7);
+    return code;
+}
+
+static uint8_t *x86_emit_mov_ri(uint8_t *code, int reg, int64_t imm) {
+    *code++ = 0x48 | (reg >= 8);
+    *code++ = 0xb8 | (reg & 7);                            // mov reg, imm64
+    memcpy(code, &imm, 8);
+    return code + 8;
+}
+
+// mov between a register and its spill slot at [rbp - 8*(slot+1)]
+static uint8_t *x86_emit_spill_mov(uint8_t *code, int reg, int slot, int to_memory) {
+    int32_t disp = -8 * (slot + 1);
+    *code++ = 0x48 | ((reg >= 8) << 2);
+    *code++ = to_memory ? 0x89 : 0x8b;
+    *code++ = 0x80 | ((reg & 7) << 3) | 5;                 // [rbp + disp32]
+    memcpy(code, &disp, 4);
+    return code + 4;
+}
+
+// SSE memory op: prefix + REX + 0F op + ModRM [base]
+static uint8_t *x86_emit_sse_mem(uint8_t *code, uint8_t prefix, uint8_t op,
+                                 int xmm, int base) {
+    *code++ = prefix;
+    if (base >= 8) *code++ = 0x41;                        // REX.B
+    *code++ = 0x0f; *code++ = op;
+    if ((base & 7) == 5) {                                 // rbp/r13: disp8 form
+        *code++ = 0x40 | (xmm << 3) | (base & 7);
+        *code++ = 0x00;
+    } else {
+        *code++ = (xmm << 3) | (base & 7);
+        if ((base & 7) == 4) *code++ = 0x24;               // rsp/r12: SIB
+    }
+    return code;
+}
+
+// AVX2 memory op via three-byte VEX (handles REX.B addresses), L=256
+static uint8_t *x86_emit_vex_mem(uint8_t *code, uint8_t pp, uint8_t op,
+                                 int ymm, int base) {
+    *code++ = 0xc4;
+    *code++ = 0xc0 | ((base >= 8) ? 0 : 0x20) | 0x01;      // ~R ~X ~B, mmmmm=0F
+    *code++ = 0x78 | 0x04 | pp;                            // W=0, vvvv=1111, L=1
+    *code++ = op;
+    if ((base & 7) == 5) {
+        *code++ = 0x40 | (ymm << 3) | (base & 7);
+        *code++ = 0x00;
+    } else {
+        *code++ = (ymm << 3) | (base & 7);
+        if ((base & 7) == 4) *code++ = 0x24;
+    }
+    return code;
+}
+
+// Returns the hardware register holding `value`, loading constants and
+// spilled values into `scratch` as needed
+static int x86_operand_reg(jit_function_t *func, const jit_value_t *value,
+                           uint8_t **code, int scratch) {
+    if (value->is_constant) {
+        *code = x86_emit_mov_ri(*code, scratch, value->constant_value);
+        return scratch;
+    }
+    virtual_reg_t *vreg = &func->reg_allocator.virtual_regs[value->id];
+    if (vreg->spilled) {
+        *code = x86_emit_spill_mov(*code, scratch, vreg->stack_slot, 0);
+        return scratch;
+    }
+    return vreg->physical_reg >= 0 ? vreg->physical_reg : scratch;
+}
+
 static void codegen_x86_64(jit_function_t *func, uint8_t *code_buffer, size_t *code_size) {
     uint8_t *code = code_buffer;
-    
+
+    jit_block_t **blocks = calloc(func->num_blocks, sizeof(jit_block_t *));
+    size_t *block_offsets = calloc(func->num_blocks, sizeof(size_t));
+    size_t max_fixups = count_branch_fixups(func);
+    branch_fixup_t *fixups = max_fixups ? calloc(max_fixups, sizeof(branch_fixup_t)) : NULL;
+    size_t num_blocks = 0, num_fixups = 0;
+
     // Function prologue
-    *code++ = 0x55;                    // push rbp
-    *code++ = 0x48; *code++ = 0x89; *code++ = 0xe5;  // mov rbp, rsp
-    
-    // Generate code for each basic block
+    *code++ = 0x55;                                        // push rbp
+    *code++ = 0x48; *code++ = 0x89; *code++ = 0xe5;        // mov rbp, rsp
+    int32_t frame = (func->reg_allocator.num_stack_slots * 8 + 15) & ~15;
+    if (frame > 0) {
+        *code++ = 0x48; *code++ = 0x81; *code++ = 0xec;    // sub rsp, imm32
+        memcpy(code, &frame, 4);
+        code += 4;
+    }
+
     jit_block_t *block = func->entry_block;
     while (block) {
+        blocks[num_blocks] = block;
+        block_offsets[num_blocks++] = (size_t)(code - code_buffer);
+        int vec_slot = 0;  // packed loads alternate xmm0/xmm1 per block
         jit_instruction_t *inst = block->instructions;
         while (inst) {
             switch (inst->opcode) {
                 case JIT_OP_ADD:
-                    // add reg, reg (simplified)
-                    *code++ = 0x48; *code++ = 0x01; *code++ = 0xc0;
-                    break;
-                    
                 case JIT_OP_SUB:
-                    // sub reg, reg
-                    *code++ = 0x48; *code++ = 0x29; *code++ = 0xc0;
-                    break;
-                    
-                case JIT_OP_MUL:
-                    // imul reg, reg
-                    *code++ = 0x48; *code++ = 0x0f; *code++ = 0xaf; *code++ = 0xc0;
+                case JIT_OP_MUL: {
+                    int src1 = x86_operand_reg(func, &inst->src1, &code, X86_SCRATCH0);
+                    int src2 = x86_operand_reg(func, &inst->src2, &code, X86_SCRATCH1);
+                    virtual_reg_t *dest = &func->reg_allocator.virtual_regs[inst->dest.id];
+                    int dst = dest->spilled ? X86_SCRATCH0 : dest->physical_reg;
+
+                    if (dst != src1) {
+                        code = x86_emit_rr(code, 0x89, src1, dst);   // mov dst, src1
+                    }
+                    if (inst->opcode == JIT_OP_ADD) {
+                        code = x86_emit_rr(code, 0x01, src2, dst);   // add dst, src2
+                    } else if (inst->opcode == JIT_OP_SUB) {
+                        code = x86_emit_rr(code, 0x29, src2, dst);   // sub dst, src2
+                    } else {
+                        code = x86_emit_imul_rr(code, dst, src2);    // imul dst, src2
+                    }
+                    if (dest->spilled) {
+                        code = x86_emit_spill_mov(code, dst, dest->stack_slot, 1);
+                    }
                     break;
-                    
-                case JIT_OP_MOV:
+                }
+
+                case JIT_OP_MOV: {
+                    virtual_reg_t *dest = &func->reg_allocator.virtual_regs[inst->dest.id];
+                    int dst = dest->spilled ? X86_SCRATCH0 : dest->physical_reg;
                     if (inst->src1.is_constant) {
-                        // mov reg, imm64
-                        *code++ = 0x48; *code++ = 0xb8;  // mov rax, imm64
-                        *(int64_t*)code = inst->src1.constant_value;
-                        code += 8;
+                        code = x86_emit_mov_ri(code, dst, inst->src1.constant_value);
                     } else {
-                        // mov reg, reg
-                        *code++ = 0x48; *code++ = 0x89; *code++ = 0xc0;
+                        int src = x86_operand_reg(func, &inst->src1, &code, X86_SCRATCH0);
+                        if (src != dst) {
+                            code = x86_emit_rr(code, 0x89, src, dst);
+                        }
+                    }
+                    if (dest->spilled) {
+                        code = x86_emit_spill_mov(code, dst, dest->stack_slot, 1);
+                    }
+                    break;
+                }
+
+                case JIT_OP_BRANCH: {
+                    *code++ = 0xe9;                                  // jmp rel32
+                    fixups[num_fixups].patch_at = (size_t)(code - code_buffer);
+                    fixups[num_fixups++].target = inst->target_block;
+                    code += 4;
+                    break;
+                }
+
+                case JIT_OP_BRANCH_IF: {
+                    int cond = x86_operand_reg(func, &inst->src1, &code, X86_SCRATCH0);
+                    code = x86_emit_rr(code, 0x85, cond, cond);      // test cond, cond
+                    *code++ = 0x0f; *code++ = 0x85;                  // jnz rel32
+                    fixups[num_fixups].patch_at = (size_t)(code - code_buffer);
+                    fixups[num_fixups++].target = inst->target_block;
+                    code += 4;
+                    if (inst->else_block && inst->else_block != block->next) {
+                        *code++ = 0xe9;                              // jmp rel32
+                        fixups[num_fixups].patch_at = (size_t)(code - code_buffer);
+                        fixups[num_fixups++].target = inst->else_block;
+                        code += 4;
                     }
                     break;
-                    
-                case JIT_OP_RETURN:
-                    // Function epilogue
+                }
+
+                case JIT_OP_RETURN: {
+                    // Result goes in rax
+                    int src = x86_operand_reg(func, &inst->src1, &code, X86_SCRATCH0);
+                    if (src != 0) {
+                        code = x86_emit_rr(code, 0x89, src, 0);      // mov rax, src
+                    }
                     *code++ = 0x48; *code++ = 0x89; *code++ = 0xec;  // mov rsp, rbp
-                    *code++ = 0x5d;                                   // pop rbp
-                    *code++ = 0xc3;                                   // ret
+                    *code++ = 0x5d;                                  // pop rbp
+                    *code++ = 0xc3;                                  // ret
+                    break;
+                }
+
+                case JIT_OP_VLOAD: {
+                    int addr = x86_operand_reg(func, &inst->src1, &code, X86_SCRATCH0);
+                    if (inst->vector_width >= 8) {
+                        code = x86_emit_vex_mem(code, 0x02, 0x6f, vec_slot, addr);  // vmovdqu ymmN, [addr]
+                    } else {
+                        code = x86_emit_sse_mem(code, 0xf3, 0x6f, vec_slot, addr);  // movdqu xmmN, [addr]
+                    }
+                    vec_slot ^= 1;
+                    break;
+                }
+
+                case JIT_OP_VSTORE: {
+                    int addr = x86_operand_reg(func, &inst->src1, &code, X86_SCRATCH0);
+                    if (inst->vector_width >= 8) {
+                        code = x86_emit_vex_mem(code, 0x02, 0x7f, 0, addr);         // vmovdqu [addr], ymm0
+                    } else {
+                        code = x86_emit_sse_mem(code, 0xf3, 0x7f, 0, addr);         // movdqu [addr], xmm0
+                    }
+                    break;
+                }
+
+                case JIT_OP_VADD:
+                case JIT_OP_VSUB:
+                case JIT_OP_VMUL:
+                    // Result lands in xmm0/ymm0 for the following VSTORE
+                    if (inst->vector_width >= 8) {
+                        if (inst->opcode == JIT_OP_VADD) {
+                            *code++ = 0xc5; *code++ = 0xfd; *code++ = 0xfe; *code++ = 0xc1;  // vpaddd ymm0, ymm0, ymm1
+                        } else if (inst->opcode == JIT_OP_VSUB) {
+                            *code++ = 0xc5; *code++ = 0xfd; *code++ = 0xfa; *code++ = 0xc1;  // vpsubd
+                        } else {
+                            *code++ = 0xc4; *code++ = 0xe2; *code++ = 0x7d;
+                            *code++ = 0x40; *code++ = 0xc1;                                  // vpmulld
+                        }
+                    } else {
+                        if (inst->opcode == JIT_OP_VADD) {
+                            *code++ = 0x66; *code++ = 0x0f; *code++ = 0xfe; *code++ = 0xc1;  // paddd xmm0, xmm1
+                        } else if (inst->opcode == JIT_OP_VSUB) {
+                            *code++ = 0x66; *code++ = 0x0f; *code++ = 0xfa; *code++ = 0xc1;  // psubd
+                        } else {
+                            *code++ = 0x66; *code++ = 0x0f; *code++ = 0x38;
+                            *code++ = 0x40; *code++ = 0xc1;                                  // pmulld (SSE4.1)
+                        }
+                    }
+                    vec_slot = 0;
                     break;
-                    
+
                 default:
                     break;
             }
@@ -485,41 +1078,355 @@ static void codegen_x86_64(jit_function_t *func, uint8_t *code_buffer, size_t *c
         }
         block = block->next;
     }
-    
+
+    // Resolve branch displacements now that every block has an offset
+    for (size_t i = 0; i < num_fixups; i++) {
+        size_t target = branch_target_offset(blocks, block_offsets, num_blocks,
+                                             fixups[i].target);
+        int32_t rel = (int32_t)(target - (fixups[i].patch_at + 4));
+        memcpy(code_buffer + fixups[i].patch_at, &rel, 4);
+    }
+    free(blocks);
+    free(block_offsets);
+    free(fixups);
+
     *code_size = code - code_buffer;
 }
 
-// ARM64 code generation
+// ARM64 code generation (scratch: x9/x10)
+
+#define ARM64_SCRATCH0 9
+#define ARM64_SCRATCH1 10
+
+static uint32_t *arm64_emit_mov_ri(uint32_t *code, int reg, int64_t imm) {
+    uint64_t bits = (uint64_t)imm;
+    *code++ = 0xd2800000 | ((uint32_t)(bits & 0xffff) << 5) | reg;          // movz
+    for (int shift = 1; shift < 4; shift++) {
+        uint32_t chunk = (bits >> (16 * shift)) & 0xffff;
+        if (chunk) {
+            *code++ = 0xf2800000 | ((uint32_t)shift << 21) | (chunk << 5) | reg; // movk
+        }
+    }
+    return code;
+}
+
+// ldur/stur x_reg, [x29, #-8*(slot+1)]
+static uint32_t *arm64_emit_spill_mov(uint32_t *code, int reg, int slot, int to_memory) {
+    int32_t offset = -8 * (slot + 1);
+    uint32_t imm9 = (uint32_t)offset & 0x1ff;
+    *code++ = (to_memory ? 0xf8000000u : 0xf8400000u) | (imm9 << 12) | (29u << 5) | reg;
+    return code;
+}
+
+static int arm64_operand_reg(jit_function_t *func, const jit_value_t *value,
+                             uint32_t **code, int scratch) {
+    if (value->is_constant) {
+        *code = arm64_emit_mov_ri(*code, scratch, value->constant_value);
+        return scratch;
+    }
+    virtual_reg_t *vreg = &func->reg_allocator.virtual_regs[value->id];
+    if (vreg->spilled) {
+        *code = arm64_emit_spill_mov(*code, scratch, vreg->stack_slot, 0);
+        return scratch;
+    }
+    return vreg->physical_reg >= 0 ? vreg->physical_reg : scratch;
+}
+
 static void codegen_arm64(jit_function_t *func, uint8_t *code_buffer, size_t *code_size) {
     uint32_t *code = (uint32_t *)code_buffer;
-    
+
+    jit_block_t **blocks = calloc(func->num_blocks, sizeof(jit_block_t *));
+    size_t *block_offsets = calloc(func->num_blocks, sizeof(size_t));
+    size_t max_fixups = count_branch_fixups(func);
+    branch_fixup_t *fixups = max_fixups ? calloc(max_fixups, sizeof(branch_fixup_t)) : NULL;
+    size_t num_blocks = 0, num_fixups = 0;
+
     // Function prologue
     *code++ = 0xa9bf7bfd;  // stp x29, x30, [sp, #-16]!
     *code++ = 0x910003fd;  // mov x29, sp
-    
-    // Generate code for each basic block
+    uint32_t frame = (uint32_t)((func->reg_allocator.num_stack_slots * 8 + 15) & ~15);
+    if (frame > 0) {
+        *code++ = 0xd10003ff | (frame << 10);  // sub sp, sp, #frame
+    }
+
     jit_block_t *block = func->entry_block;
     while (block) {
+        blocks[num_blocks] = block;
+        block_offsets[num_blocks++] = (size_t)(code - (uint32_t *)code_buffer);
+        int vec_slot = 0;  // packed loads alternate v0/v1 per block
         jit_instruction_t *inst = block->instructions;
         while (inst) {
             switch (inst->opcode) {
                 case JIT_OP_ADD:
-                    *code++ = 0x8b000000;  // add x0, x0, x0 (simplified)
+                case JIT_OP_SUB:
+                case JIT_OP_MUL: {
+                    int src1 = arm64_operand_reg(func, &inst->src1, &code, ARM64_SCRATCH0);
+                    int src2 = arm64_operand_reg(func, &inst->src2, &code, ARM64_SCRATCH1);
+                    virtual_reg_t *dest = &func->reg_allocator.virtual_regs[inst->dest.id];
+                    int dst = dest->spilled ? ARM64_SCRATCH0 : dest->physical_reg;
+
+                    if (inst->opcode == JIT_OP_ADD) {
+                        *code++ = 0x8b000000 | ((uint32_t)src2 << 16) | ((uint32_t)src1 << 5) | dst;
+                    } else if (inst->opcode == JIT_OP_SUB) {
+                        *code++ = 0xcb000000 | ((uint32_t)src2 << 16) | ((uint32_t)src1 << 5) | dst;
+                    } else {
+                        *code++ = 0x9b007c00 | ((uint32_t)src2 << 16) | ((uint32_t)src1 << 5) | dst;
+                    }
+                    if (dest->spilled) {
+                        code = arm64_emit_spill_mov(code, dst, dest->stack_slot, 1);
+                    }
+                    break;
+                }
+
+                case JIT_OP_MOV: {
+                    virtual_reg_t *dest = &func->reg_allocator.virtual_regs[inst->dest.id];
+                    int dst = dest->spilled ? ARM64_SCRATCH0 : dest->physical_reg;
+                    if (inst->src1.is_constant) {
+                        code = arm64_emit_mov_ri(code, dst, inst->src1.constant_value);
+                    } else {
+                        int src = arm64_operand_reg(func, &inst->src1, &code, ARM64_SCRATCH0);
+                        if (src != dst) {
+                            *code++ = 0xaa0003e0 | ((uint32_t)src << 16) | dst; // orr dst, xzr, src
+                        }
+                    }
+                    if (dest->spilled) {
+                        code = arm64_emit_spill_mov(code, dst, dest->stack_slot, 1);
+                    }
+                    break;
+                }
+
+                case JIT_OP_BRANCH: {
+                    fixups[num_fixups].patch_at = (size_t)(code - (uint32_t *)code_buffer);
+                    fixups[num_fixups++].target = inst->target_block;
+                    *code++ = 0x14000000;  // b target (imm26 patched later)
+                    break;
+                }
+
+                case JIT_OP_BRANCH_IF: {
+                    int cond = arm64_operand_reg(func, &inst->src1, &code, ARM64_SCRATCH0);
+                    fixups[num_fixups].patch_at = (size_t)(code - (uint32_t *)code_buffer);
+                    fixups[num_fixups++].target = inst->target_block;
+                    *code++ = 0xb5000000 | (uint32_t)cond;  // cbnz cond, target
+                    if (inst->else_block && inst->else_block != block->next) {
+                        fixups[num_fixups].patch_at = (size_t)(code - (uint32_t *)code_buffer);
+                        fixups[num_fixups++].target = inst->else_block;
+                        *code++ = 0x14000000;  // b else
+                    }
+                    break;
+                }
+
+                case JIT_OP_RETURN: {
+                    int src = arm64_operand_reg(func, &inst->src1, &code, ARM64_SCRATCH0);
+                    if (src != 0) {
+                        *code++ = 0xaa0003e0 | ((uint32_t)src << 16) | 0;  // orr x0, xzr, src
+                    }
+                    if (frame > 0) {
+                        *code++ = 0x910003bf;  // mov sp, x29
+                    }
+                    *code++ = 0xa8c17bfd;      // ldp x29, x30, [sp], #16
+                    *code++ = 0xd65f03c0;      // ret
                     break;
-                    
+                }
+
+                case JIT_OP_VLOAD: {
+                    int addr = arm64_operand_reg(func, &inst->src1, &code, ARM64_SCRATCH0);
+                    *code++ = 0x4c407800 | ((uint32_t)addr << 5) | vec_slot;  // ld1 {vN.4s}, [addr]
+                    vec_slot ^= 1;
+                    break;
+                }
+
+                case JIT_OP_VSTORE: {
+                    int addr = arm64_operand_reg(func, &inst->src1, &code, ARM64_SCRATCH0);
+                    *code++ = 0x4c007800 | ((uint32_t)addr << 5);             // st1 {v0.4s}, [addr]
+                    break;
+                }
+
+                case JIT_OP_VADD:
+                case JIT_OP_VSUB:
+                case JIT_OP_VMUL:
+                    // Result lands in v0 for the following VSTORE
+                    if (inst->opcode == JIT_OP_VADD) {
+                        *code++ = 0x4ea18400;  // add v0.4s, v0.4s, v1.4s
+                    } else if (inst->opcode == JIT_OP_VSUB) {
+                        *code++ = 0x6ea18400;  // sub v0.4s, v0.4s, v1.4s
+                    } else {
+                        *code++ = 0x4ea19c00;  // mul v0.4s, v0.4s, v1.4s
+                    }
+                    vec_slot = 0;
+                    break;
+
+                default:
+                    break;
+            }
+            inst = inst->next;
+        }
+        block = block->next;
+    }
+
+    // Word-granular displacements: b gets imm26, cbnz gets imm19
+    uint32_t *base = (uint32_t *)code_buffer;
+    for (size_t i = 0; i < num_fixups; i++) {
+        size_t target = branch_target_offset(blocks, block_offsets, num_blocks,
+                                             fixups[i].target);
+        int32_t delta = (int32_t)target - (int32_t)fixups[i].patch_at;
+        uint32_t insn = base[fixups[i].patch_at];
+        if ((insn & 0xfc000000) == 0x14000000) {
+            base[fixups[i].patch_at] = 0x14000000 | ((uint32_t)delta & 0x3ffffff);
+        } else {
+            base[fixups[i].patch_at] = insn | (((uint32_t)delta & 0x7ffff) << 5);
+        }
+    }
+    free(blocks);
+    free(block_offsets);
+    free(fixups);
+
+    *code_size = (uint8_t *)code - code_buffer;
+}
+
+// RISC-V code generation (scratch: t5/t6 = x30/x31)
+
+#define RISCV_SCRATCH0 30
+#define RISCV_SCRATCH1 31
+
+static uint32_t *riscv_emit_rtype(uint32_t *code, uint32_t funct7, int rs2,
+                                  int rs1, uint32_t funct3, int rd) {
+    *code++ = (funct7 << 25) | ((uint32_t)rs2 << 20) | ((uint32_t)rs1 << 15) |
+              (funct3 << 12) | ((uint32_t)rd << 7) | 0x33;
+    return code;
+}
+
+static uint32_t *riscv_emit_mov_ri(uint32_t *code, int reg, int64_t imm) {
+    int32_t value = (int32_t)imm;  // 32-bit immediates; wide constants rare in filters
+    int32_t hi = (value + 0x800) >> 12;
+    int32_t lo = value - (hi << 12);
+    if (hi) {
+        *code++ = ((uint32_t)hi << 12) | ((uint32_t)reg << 7) | 0x37;  // lui
+        *code++ = ((uint32_t)(lo & 0xfff) << 20) | ((uint32_t)reg << 15) |
+                  ((uint32_t)reg << 7) | 0x13;                          // addi reg, reg, lo
+    } else {
+        *code++ = ((uint32_t)(lo & 0xfff) << 20) | ((uint32_t)reg << 7) | 0x13; // addi reg, x0
+    }
+    return code;
+}
+
+// ld/sd between reg and its spill slot at sp + 8*slot
+static uint32_t *riscv_emit_spill_mov(uint32_t *code, int reg, int slot, int to_memory) {
+    uint32_t offset = (uint32_t)(8 * slot);
+    if (to_memory) {
+        *code++ = ((offset >> 5) << 25) | ((uint32_t)reg << 20) | (2u << 15) |
+                  (3u << 12) | ((offset & 0x1f) << 7) | 0x23;   // sd reg, off(sp)
+    } else {
+        *code++ = (offset << 20) | (2u << 15) | (3u << 12) |
+                  ((uint32_t)reg << 7) | 0x03;                  // ld reg, off(sp)
+    }
+    return code;
+}
+
+static int riscv_operand_reg(jit_function_t *func, const jit_value_t *value,
+                             uint32_t **code, int scratch) {
+    if (value->is_constant) {
+        *code = riscv_emit_mov_ri(*code, scratch, value->constant_value);
+        return scratch;
+    }
+    virtual_reg_t *vreg = &func->reg_allocator.virtual_regs[value->id];
+    if (vreg->spilled) {
+        *code = riscv_emit_spill_mov(*code, scratch, vreg->stack_slot, 0);
+        return scratch;
+    }
+    return vreg->physical_reg >= 0 ? vreg->physical_reg : scratch;
+}
+
+static void codegen_riscv64(jit_function_t *func, uint8_t *code_buffer, size_t *code_size) {
+    uint32_t *code = (uint32_t *)code_buffer;
+
+    jit_block_t **blocks = calloc(func->num_blocks, sizeof(jit_block_t *));
+    size_t *block_offsets = calloc(func->num_blocks, sizeof(size_t));
+    size_t max_fixups = count_branch_fixups(func);
+    branch_fixup_t *fixups = max_fixups ? calloc(max_fixups, sizeof(branch_fixup_t)) : NULL;
+    size_t num_blocks = 0, num_fixups = 0;
+
+    int32_t frame = (func->reg_allocator.num_stack_slots * 8 + 15) & ~15;
+    if (frame > 0) {
+        *code++ = ((uint32_t)(-frame & 0xfff) << 20) | (2u << 15) | (2u << 7) | 0x13; // addi sp, sp, -frame
+    }
+
+    jit_block_t *block = func->entry_block;
+    while (block) {
+        blocks[num_blocks] = block;
+        block_offsets[num_blocks++] = (size_t)(code - (uint32_t *)code_buffer);
+        jit_instruction_t *inst = block->instructions;
+        while (inst) {
+            switch (inst->opcode) {
+                case JIT_OP_ADD:
                 case JIT_OP_SUB:
-                    *code++ = 0xcb000000;  // sub x0, x0, x0
+                case JIT_OP_MUL: {
+                    int src1 = riscv_operand_reg(func, &inst->src1, &code, RISCV_SCRATCH0);
+                    int src2 = riscv_operand_reg(func, &inst->src2, &code, RISCV_SCRATCH1);
+                    virtual_reg_t *dest = &func->reg_allocator.virtual_regs[inst->dest.id];
+                    int dst = dest->spilled ? RISCV_SCRATCH0 : dest->physical_reg;
+
+                    if (inst->opcode == JIT_OP_ADD) {
+                        code = riscv_emit_rtype(code, 0x00, src2, src1, 0, dst);
+                    } else if (inst->opcode == JIT_OP_SUB) {
+                        code = riscv_emit_rtype(code, 0x20, src2, src1, 0, dst);
+                    } else {
+                        code = riscv_emit_rtype(code, 0x01, src2, src1, 0, dst);  // mul (M ext)
+                    }
+                    if (dest->spilled) {
+                        code = riscv_emit_spill_mov(code, dst, dest->stack_slot, 1);
+                    }
                     break;
-                    
-                case JIT_OP_MUL:
-                    *code++ = 0x9b007c00;  // mul x0, x0, x0
+                }
+
+                case JIT_OP_MOV: {
+                    virtual_reg_t *dest = &func->reg_allocator.virtual_regs[inst->dest.id];
+                    int dst = dest->spilled ? RISCV_SCRATCH0 : dest->physical_reg;
+                    if (inst->src1.is_constant) {
+                        code = riscv_emit_mov_ri(code, dst, inst->src1.constant_value);
+                    } else {
+                        int src = riscv_operand_reg(func, &inst->src1, &code, RISCV_SCRATCH0);
+                        if (src != dst) {
+                            *code++ = ((uint32_t)src << 15) | ((uint32_t)dst << 7) | 0x13; // addi dst, src, 0
+                        }
+                    }
+                    if (dest->spilled) {
+                        code = riscv_emit_spill_mov(code, dst, dest->stack_slot, 1);
+                    }
                     break;
-                    
-                case JIT_OP_RETURN:
-                    *code++ = 0xa8c17bfd;  // ldp x29, x30, [sp], #16
-                    *code++ = 0xd65f03c0;  // ret
+                }
+
+                case JIT_OP_BRANCH: {
+                    fixups[num_fixups].patch_at = (size_t)(code - (uint32_t *)code_buffer);
+                    fixups[num_fixups++].target = inst->target_block;
+                    *code++ = 0x0000006f;  // jal x0, target (imm patched later)
                     break;
-                    
+                }
+
+                case JIT_OP_BRANCH_IF: {
+                    int cond = riscv_operand_reg(func, &inst->src1, &code, RISCV_SCRATCH0);
+                    fixups[num_fixups].patch_at = (size_t)(code - (uint32_t *)code_buffer);
+                    fixups[num_fixups++].target = inst->target_block;
+                    *code++ = ((uint32_t)cond << 15) | (1u << 12) | 0x63;  // bne cond, x0, target
+                    if (inst->else_block && inst->else_block != block->next) {
+                        fixups[num_fixups].patch_at = (size_t)(code - (uint32_t *)code_buffer);
+                        fixups[num_fixups++].target = inst->else_block;
+                        *code++ = 0x0000006f;  // jal x0, else
+                    }
+                    break;
+                }
+
+                case JIT_OP_RETURN: {
+                    int src = riscv_operand_reg(func, &inst->src1, &code, RISCV_SCRATCH0);
+                    if (src != 10) {
+                        *code++ = ((uint32_t)src << 15) | (10u << 7) | 0x13;  // addi a0, src, 0
+                    }
+                    if (frame > 0) {
+                        *code++ = ((uint32_t)(frame & 0xfff) << 20) | (2u << 15) | (2u << 7) | 0x13;
+                    }
+                    *code++ = 0x00008067;  // ret (jalr x0, ra, 0)
+                    break;
+                }
+
                 default:
                     break;
             }
@@ -527,46 +1434,311 @@ static void codegen_arm64(jit_function_t *func, uint8_t *code_buffer, size_t *co
         }
         block = block->next;
     }
-    
+
+    // Scatter the byte displacement into the J-type (jal) or B-type (bne)
+    // immediate fields. B-type reaches ±4KB, ample for these functions.
+    uint32_t *base = (uint32_t *)code_buffer;
+    for (size_t i = 0; i < num_fixups; i++) {
+        size_t target = branch_target_offset(blocks, block_offsets, num_blocks,
+                                             fixups[i].target);
+        uint32_t imm = (uint32_t)(((int32_t)target - (int32_t)fixups[i].patch_at) * 4);
+        uint32_t insn = base[fixups[i].patch_at];
+        if ((insn & 0x7f) == 0x6f) {
+            base[fixups[i].patch_at] = insn |
+                (((imm >> 20) & 1) << 31) | (((imm >> 1) & 0x3ff) << 21) |
+                (((imm >> 11) & 1) << 20) | (((imm >> 12) & 0xff) << 12);
+        } else {
+            base[fixups[i].patch_at] = insn |
+                (((imm >> 12) & 1) << 31) | (((imm >> 5) & 0x3f) << 25) |
+                (((imm >> 1) & 0xf) << 8) | (((imm >> 11) & 1) << 7);
+        }
+    }
+    free(blocks);
+    free(block_offsets);
+    free(fixups);
+
     *code_size = (uint8_t *)code - code_buffer;
 }
 
-// Compile function to native code
-void *jit_function_compile(jit_function_t *func) {
-    if (!func || !g_jit_context.initialized) {
-        return NULL;
+// Emit a call counter bump at the function entry (baseline tier only).
+// Uses the codegen scratch registers, which are dead at entry.
+static uint8_t *emit_call_counter(uint8_t *code, uint64_t *counter) {
+    switch (g_jit_context.target_arch) {
+        case JIT_ARCH_X86_64:
+            *code++ = 0x49; *code++ = 0xbb;                // mov r11, &counter
+            memcpy(code, &counter, 8);
+            code += 8;
+            *code++ = 0x49; *code++ = 0xff; *code++ = 0x03; // inc qword [r11]
+            break;
+
+        case JIT_ARCH_ARM64: {
+            uint32_t *c = (uint32_t *)code;
+            c = arm64_emit_mov_ri(c, ARM64_SCRATCH0, (int64_t)(uintptr_t)counter);
+            *c++ = 0xf9400000 | (ARM64_SCRATCH0 << 5) | ARM64_SCRATCH1;  // ldr x10, [x9]
+            *c++ = 0x91000400 | (ARM64_SCRATCH1 << 5) | ARM64_SCRATCH1;  // add x10, x10, #1
+            *c++ = 0xf9000000 | (ARM64_SCRATCH0 << 5) | ARM64_SCRATCH1;  // str x10, [x9]
+            code = (uint8_t *)c;
+            break;
+        }
+
+        case JIT_ARCH_RISCV64: {
+            // 64-bit address built as hi32 << 32 + sign-extended lo32
+            uint64_t addr = (uint64_t)(uintptr_t)counter;
+            int64_t hi = (int64_t)((addr + 0x80000000ull) >> 32);
+            int64_t lo = (int64_t)(int32_t)(addr - ((uint64_t)hi << 32));
+            uint32_t *c = (uint32_t *)code;
+            c = riscv_emit_mov_ri(c, RISCV_SCRATCH0, hi);
+            *c++ = (32u << 20) | (30u << 15) | (1u << 12) | (30u << 7) | 0x13; // slli t5, t5, 32
+            c = riscv_emit_mov_ri(c, RISCV_SCRATCH1, lo);
+            *c++ = (31u << 20) | (30u << 15) | (30u << 7) | 0x33;              // add t5, t5, t6
+            *c++ = (30u << 15) | (3u << 12) | (31u << 7) | 0x03;               // ld t6, 0(t5)
+            *c++ = (1u << 20) | (31u << 15) | (31u << 7) | 0x13;               // addi t6, t6, 1
+            *c++ = (31u << 20) | (30u << 15) | (3u << 12) | 0x23;              // sd t6, 0(t5)
+            code = (uint8_t *)c;
+            break;
+        }
     }
-    
-    // Apply optimization passes
-    eliminate_dead_code(func);
-    constant_folding(func);
-    
+    return code;
+}
+
+// Shared lowering path. The optimized tier runs the full pass pipeline;
+// the baseline tier skips it and plants a call counter for the monitor.
+static void *jit_emit(jit_function_t *func, int optimize, int profile) {
+    if (optimize) {
+        eliminate_dead_code(func);
+        constant_folding(func);
+
+        // Vectorize countable loops: 8 int32 lanes with AVX2, else 4
+        // with SSE/NEON. The RISC-V backend has no packed lowering yet
+        // and stays scalar.
+        switch (g_jit_context.target_arch) {
+            case JIT_ARCH_X86_64:
+                vectorize_loops(func, g_jit_context.has_avx2 ? 8 : 4);
+                break;
+            case JIT_ARCH_ARM64:
+                vectorize_loops(func, 4);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Assign hardware registers before lowering
+    switch (g_jit_context.target_arch) {
+        case JIT_ARCH_X86_64:
+            linear_scan_allocate(func, x86_64_alloc_regs,
+                                 sizeof(x86_64_alloc_regs) / sizeof(int));
+            break;
+        case JIT_ARCH_ARM64:
+            linear_scan_allocate(func, arm64_alloc_regs,
+                                 sizeof(arm64_alloc_regs) / sizeof(int));
+            break;
+        case JIT_ARCH_RISCV64:
+            linear_scan_allocate(func, riscv_alloc_regs,
+                                 sizeof(riscv_alloc_regs) / sizeof(int));
+            break;
+    }
+
     // Generate native code
     size_t code_size = 0;
     uint8_t *code_start = g_jit_context.code_ptr;
-    
+    uint8_t *body = code_start;
+
+    if (profile) {
+        body = emit_call_counter(body, &func->call_count);
+    }
+
     switch (g_jit_context.target_arch) {
         case JIT_ARCH_X86_64:
-            codegen_x86_64(func, code_start, &code_size);
+            codegen_x86_64(func, body, &code_size);
             break;
-            
+
         case JIT_ARCH_ARM64:
-            codegen_arm64(func, code_start, &code_size);
+            codegen_arm64(func, body, &code_size);
             break;
-            
+
+        case JIT_ARCH_RISCV64:
+            codegen_riscv64(func, body, &code_size);
+            break;
+
         default:
             return NULL;
     }
-    
+
+    code_size += (size_t)(body - code_start);
+
     // Update code pointer
-    g_jit_context.code_ptr = (uint8_t*)g_jit_context.code_ptr + code_size;
-    
+    g_jit_context.code_ptr = code_start + code_size;
+
     // Make sure code is executable
     __builtin___clear_cache(code_start, code_start + code_size);
-    
+
     return code_start;
 }
 
+// Serializes all code-cache allocation (foreground compiles, tiered
+// registration and background promotion)
+static pthread_mutex_t g_tier_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Compile function to native code (single-shot, full pipeline)
+void *jit_function_compile(jit_function_t *func) {
+    if (!func || !g_jit_context.initialized) {
+        return NULL;
+    }
+    func->tier = JIT_TIER_OPTIMIZED;
+
+    // The tier monitor allocates from the same code cache under
+    // g_tier_lock; take it here too so concurrent foreground compiles
+    // and background promotions can't hand out overlapping buffers
+    pthread_mutex_lock(&g_tier_lock);
+    void *code = jit_emit(func, 1, 0);
+    pthread_mutex_unlock(&g_tier_lock);
+    return code;
+}
+
+// Tiered compilation
+//
+// jit_function_compile_tiered() returns a small trampoline that jumps
+// through a per-function entry slot. The baseline tier compiles without
+// the pass pipeline but bumps func->call_count on every entry; a
+// background monitor thread watches the counters and recompiles hot
+// functions with the full pipeline, storing the new entry into the slot
+// with a single atomic release so in-flight callers are never torn.
+
+#define JIT_HOT_THRESHOLD 10000
+#define JIT_MAX_TIERED_FUNCS 256
+
+typedef struct {
+    jit_function_t *func;
+    void **entry_slot;   // slot inside the trampoline, patched on promotion
+} tiered_entry_t;
+
+static tiered_entry_t g_tiered_funcs[JIT_MAX_TIERED_FUNCS];
+static int g_num_tiered_funcs;
+static pthread_t g_tier_thread;
+static int g_tier_thread_running;
+
+// Emit an indirect-jump trampoline with an inline 8-byte entry slot,
+// returning the callable address and the slot for later patching
+static void *emit_trampoline(void *initial_entry, void ***slot_out) {
+    // Align so the embedded slot can be stored to atomically
+    uintptr_t aligned = ((uintptr_t)g_jit_context.code_ptr + 7) & ~(uintptr_t)7;
+    uint8_t *code = (uint8_t *)aligned;
+    void **slot;
+
+    switch (g_jit_context.target_arch) {
+        case JIT_ARCH_X86_64:
+            *code++ = 0xff; *code++ = 0x25;                // jmp [rip+2]
+            *(int32_t *)code = 2; code += 4;
+            *code++ = 0x0f; *code++ = 0x1f;                // pad to align slot
+            slot = (void **)code;
+            code += 8;
+            break;
+
+        case JIT_ARCH_ARM64: {
+            uint32_t *c = (uint32_t *)code;
+            *c++ = 0x58000050;                             // ldr x16, #8
+            *c++ = 0xd61f0200;                             // br x16
+            slot = (void **)c;
+            code = (uint8_t *)c + 8;
+            break;
+        }
+
+        case JIT_ARCH_RISCV64: {
+            uint32_t *c = (uint32_t *)code;
+            *c++ = 0x00000f97;                             // auipc t6, 0
+            *c++ = 0x010fbf83;                             // ld t6, 16(t6)
+            *c++ = 0x000f8067;                             // jr t6
+            *c++ = 0x00000013;                             // nop, keeps slot 8-aligned
+            slot = (void **)c;
+            code = (uint8_t *)c + 8;
+            break;
+        }
+
+        default:
+            return NULL;
+    }
+
+    *slot = initial_entry;
+    g_jit_context.code_ptr = code;
+    __builtin___clear_cache((uint8_t *)aligned, code);
+
+    *slot_out = slot;
+    return (void *)aligned;
+}
+
+static void *tier_monitor_thread(void *arg) {
+    (void)arg;
+    while (__atomic_load_n(&g_tier_thread_running, __ATOMIC_ACQUIRE)) {
+        usleep(1000);
+
+        pthread_mutex_lock(&g_tier_lock);
+        for (int i = 0; i < g_num_tiered_funcs; i++) {
+            jit_function_t *func = g_tiered_funcs[i].func;
+            if (func->tier != JIT_TIER_BASELINE ||
+                __atomic_load_n(&func->call_count, __ATOMIC_RELAXED) < JIT_HOT_THRESHOLD) {
+                continue;
+            }
+
+            // Hot: recompile with the full pipeline and swing the entry
+            void *optimized = jit_emit(func, 1, 0);
+            if (optimized) {
+                func->tier = JIT_TIER_OPTIMIZED;
+                __atomic_store_n(g_tiered_funcs[i].entry_slot, optimized,
+                                 __ATOMIC_RELEASE);
+            }
+        }
+        pthread_mutex_unlock(&g_tier_lock);
+    }
+    return NULL;
+}
+
+// Compile at the baseline tier and register for hot promotion. Returns
+// a stable entry point that survives recompilation.
+void *jit_function_compile_tiered(jit_function_t *func) {
+    if (!func || !g_jit_context.initialized) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&g_tier_lock);
+
+    if (g_num_tiered_funcs >= JIT_MAX_TIERED_FUNCS) {
+        pthread_mutex_unlock(&g_tier_lock);
+        // Registry full: fall back to a single-shot optimized compile
+        return jit_function_compile(func);
+    }
+
+    func->tier = JIT_TIER_BASELINE;
+    func->call_count = 0;
+
+    void *baseline = jit_emit(func, 0, 1);
+    if (!baseline) {
+        pthread_mutex_unlock(&g_tier_lock);
+        return NULL;
+    }
+
+    void **slot = NULL;
+    void *entry = emit_trampoline(baseline, &slot);
+    if (!entry) {
+        pthread_mutex_unlock(&g_tier_lock);
+        return NULL;
+    }
+
+    g_tiered_funcs[g_num_tiered_funcs].func = func;
+    g_tiered_funcs[g_num_tiered_funcs].entry_slot = slot;
+    g_num_tiered_funcs++;
+
+    if (!g_tier_thread_running) {
+        __atomic_store_n(&g_tier_thread_running, 1, __ATOMIC_RELEASE);
+        if (pthread_create(&g_tier_thread, NULL, tier_monitor_thread, NULL) != 0) {
+            g_tier_thread_running = 0;
+        }
+    }
+
+    pthread_mutex_unlock(&g_tier_lock);
+    return entry;
+}
+
 // Cleanup
 void jit_function_destroy(jit_function_t *func) {
     if (!func) return;
@@ -590,6 +1762,12 @@ void jit_function_destroy(jit_function_t *func) {
 }
 
 void jit_cleanup(void) {
+    if (g_tier_thread_running) {
+        __atomic_store_n(&g_tier_thread_running, 0, __ATOMIC_RELEASE);
+        pthread_join(g_tier_thread, NULL);
+    }
+    g_num_tiered_funcs = 0;
+
     if (g_jit_context.code_cache) {
         munmap(g_jit_context.code_cache, g_jit_context.code_cache_size);
     }
@@ -18,19 +18,28 @@
  * Date: June 2025
  */
 
+#define _GNU_SOURCE
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 // Configuration constants
 #define PAGE_SIZE 4096
-#define MAX_ORDER 20
+#define HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+#define MAX_ORDER 24
+#define MAX_NUMA_NODES 8
 #define SLAB_SIZES_COUNT 16
-#define THREAD_CACHE_SIZE 64
+#define MAX_CPUS 64
+#define MAGAZINE_OBJS 16
 
 // Memory block header
 typedef struct mem_block {
@@ -59,14 +68,36 @@ typedef struct slab_cache {
     pthread_mutex_t lock;
 } slab_cache_t;
 
-// Thread-local cache
-typedef struct thread_cache {
-    void *free_lists[SLAB_SIZES_COUNT];
-    uint64_t alloc_count;
-    uint64_t free_count;
-    uint64_t cache_hits;
-    uint64_t cache_misses;
-} thread_cache_t;
+// Magazine: a fixed batch of objects moved between the per-CPU front end
+// and the central depot as one unit, so the cold path amortizes over
+// MAGAZINE_OBJS operations.
+typedef struct magazine {
+    struct magazine *next;      // depot stack linkage
+    uint32_t count;             // live objects in objs[]
+    void *objs[MAGAZINE_OBJS];
+} magazine_t;
+
+// Depot stack head: pointer + generation tag, swung with a 16-byte CAS.
+// The tag makes pop immune to ABA when a magazine is popped, recycled and
+// pushed back between a competing thread's load and CAS.
+typedef struct depot_head {
+    magazine_t *top;
+    uintptr_t tag;
+} depot_head_t;
+
+typedef struct depot_stack {
+    _Alignas(16) depot_head_t head;
+} depot_stack_t;
+
+// Per-CPU magazine slot for one size class. `loaded` is claimed with an
+// atomic exchange (NULL while a thread works on it), so the fast path is
+// a single uncontended cache line and never a lock.
+typedef struct cpu_magazine {
+    _Atomic(magazine_t*) loaded;
+    uint64_t hits;
+    uint64_t misses;
+    char pad[40]; // keep slots on separate cache lines
+} cpu_magazine_t;
 
 // Memory statistics
 typedef struct mem_stats {
@@ -79,21 +110,35 @@ typedef struct mem_stats {
     uint64_t large_allocs;
     double avg_alloc_time;
     double fragmentation_ratio;
+    // NUMA / hugepage accounting
+    uint64_t node_usage[MAX_NUMA_NODES];   // live buddy bytes per node
+    uint64_t hugepage_bytes;               // arena bytes with huge backing
+    double hugepage_coverage;              // fraction of arena bytes
 } mem_stats_t;
 
+// Per-NUMA-node buddy arena. Each node gets its own mmap'd region and
+// free lists; threads allocate from the node they are running on, so
+// buddy memory is node-local by construction.
+typedef struct buddy_arena {
+    buddy_node_t *free_lists[MAX_ORDER];
+    void *base;
+    size_t size;
+    int huge_backed;    // MAP_HUGETLB or THP via MADV_HUGEPAGE
+} buddy_arena_t;
+
 // Global allocator state
 typedef struct allocator {
-    buddy_node_t *buddy_free_lists[MAX_ORDER];
+    buddy_arena_t buddy_arenas[MAX_NUMA_NODES];
+    int numa_node_count;
     slab_cache_t slab_caches[SLAB_SIZES_COUNT];
-    void *heap_base;
-    size_t heap_size;
+    cpu_magazine_t cpu_magazines[MAX_CPUS][SLAB_SIZES_COUNT];
+    depot_stack_t depot_full[SLAB_SIZES_COUNT];   // magazines with objects
+    depot_stack_t depot_empty[SLAB_SIZES_COUNT];  // drained magazines
     mem_stats_t stats;
     pthread_mutex_t global_lock;
     uint32_t initialized;
 } allocator_t;
 
-// Thread-local storage
-static __thread thread_cache_t *thread_cache = NULL;
 static allocator_t g_allocator;
 
 // Slab sizes (powers of 2 and common sizes)
@@ -124,111 +169,211 @@ static inline uint32_t log2_ceil(size_t n) {
     return log;
 }
 
-// Buddy allocator implementation
-static void buddy_init(void) {
+// NUMA topology helpers
+static int numa_node_count(void) {
+    // Parse /sys/devices/system/node/online ("0" or "0-3"); fall back to
+    // a single node when the sysfs file is unavailable
+    int fd = open("/sys/devices/system/node/online", O_RDONLY);
+    if (fd < 0) return 1;
+
+    char buf[32] = {0};
+    ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0) return 1;
+
+    char *dash = strchr(buf, '-');
+    int highest = dash ? atoi(dash + 1) : atoi(buf);
+    int count = highest + 1;
+    if (count < 1) count = 1;
+    if (count > MAX_NUMA_NODES) count = MAX_NUMA_NODES;
+    return count;
+}
+
+static int current_numa_node(void) {
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return 0;
+    return (int)(node % (unsigned)g_allocator.numa_node_count);
+}
+
+static void bind_to_node(void *addr, size_t len, int node) {
+#ifdef __NR_mbind
+    // MPOL_BIND via raw syscall so we don't require libnuma. If the
+    // kernel refuses (no NUMA, permissions), first-touch from the
+    // allocating thread still places pages locally.
+    unsigned long nodemask = 1UL << node;
+    syscall(__NR_mbind, addr, len, 2 /* MPOL_BIND */, &nodemask,
+            sizeof(nodemask) * 8, 0);
+#else
+    (void)addr; (void)len; (void)node;
+#endif
+}
+
+// Buddy allocator implementation (one arena per NUMA node)
+static void buddy_arena_init(buddy_arena_t *arena, int node) {
     for (int i = 0; i < MAX_ORDER; i++) {
-        g_allocator.buddy_free_lists[i] = NULL;
+        arena->free_lists[i] = NULL;
     }
-    
-    // Create initial large block
+
     size_t heap_size = 1ULL << (MAX_ORDER - 1);
+
+    // Prefer explicit hugetlb pages for the arena; fall back to normal
+    // pages plus MADV_HUGEPAGE so THP can still coalesce them. Arenas are
+    // hugepage-sized multiples, so coverage is all-or-nothing per arena.
     void *heap = mmap(NULL, heap_size, PROT_READ | PROT_WRITE,
-                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    arena->huge_backed = (heap != MAP_FAILED);
     if (heap == MAP_FAILED) {
-        printf("Failed to allocate buddy heap\n");
-        return;
+        heap = mmap(NULL, heap_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (heap == MAP_FAILED) {
+            printf("Failed to allocate buddy heap for node %d\n", node);
+            arena->base = NULL;
+            arena->size = 0;
+            return;
+        }
+#ifdef MADV_HUGEPAGE
+        if (madvise(heap, heap_size, MADV_HUGEPAGE) == 0) {
+            arena->huge_backed = 1;
+        }
+#endif
     }
-    
-    g_allocator.heap_base = heap;
-    g_allocator.heap_size = heap_size;
-    
-    // Add to free list
-    buddy_node_t *node = (buddy_node_t*)heap;
-    node->next = NULL;
-    node->order = MAX_ORDER - 1;
-    node->free = 1;
-    
-    g_allocator.buddy_free_lists[MAX_ORDER - 1] = node;
+
+    bind_to_node(heap, heap_size, node);
+
+    arena->base = heap;
+    arena->size = heap_size;
+    if (arena->huge_backed) {
+        g_allocator.stats.hugepage_bytes += heap_size;
+    }
+
+    buddy_node_t *node_blk = (buddy_node_t*)heap;
+    node_blk->next = NULL;
+    node_blk->order = MAX_ORDER - 1;
+    node_blk->free = 1;
+
+    arena->free_lists[MAX_ORDER - 1] = node_blk;
 }
 
 static void *buddy_alloc(size_t size) {
     if (size == 0) return NULL;
-    
+
     uint32_t order = log2_ceil(size + sizeof(buddy_node_t));
     if (order >= MAX_ORDER) return NULL;
-    
-    // Find suitable block
-    uint32_t current_order = order;
-    while (current_order < MAX_ORDER && !g_allocator.buddy_free_lists[current_order]) {
-        current_order++;
+
+    // Start on the local node's arena; spill to other nodes only when it
+    // is exhausted (remote beats failure)
+    int home = current_numa_node();
+    for (int attempt = 0; attempt < g_allocator.numa_node_count; attempt++) {
+        int node = (home + attempt) % g_allocator.numa_node_count;
+        buddy_arena_t *arena = &g_allocator.buddy_arenas[node];
+        if (!arena->base) continue;
+
+        uint32_t current_order = order;
+        while (current_order < MAX_ORDER && !arena->free_lists[current_order]) {
+            current_order++;
+        }
+        if (current_order >= MAX_ORDER) continue;
+
+        // Remove from free list
+        buddy_node_t *blk = arena->free_lists[current_order];
+        arena->free_lists[current_order] = blk->next;
+
+        // Split blocks if necessary
+        while (current_order > order) {
+            current_order--;
+
+            buddy_node_t *buddy = (buddy_node_t*)((char*)blk + (1ULL << current_order));
+            buddy->order = current_order;
+            buddy->free = 1;
+            buddy->next = arena->free_lists[current_order];
+            arena->free_lists[current_order] = buddy;
+        }
+
+        blk->free = 0;
+        blk->order = order;
+        g_allocator.stats.buddy_allocs++;
+        g_allocator.stats.node_usage[node] += 1ULL << order;
+
+        return (char*)blk + sizeof(buddy_node_t);
     }
-    
-    if (current_order >= MAX_ORDER) return NULL;
-    
-    // Remove from free list
-    buddy_node_t *node = g_allocator.buddy_free_lists[current_order];
-    g_allocator.buddy_free_lists[current_order] = node->next;
-    
-    // Split blocks if necessary
-    while (current_order > order) {
-        current_order--;
-        
-        buddy_node_t *buddy = (buddy_node_t*)((char*)node + (1ULL << current_order));
-        buddy->order = current_order;
-        buddy->free = 1;
-        buddy->next = g_allocator.buddy_free_lists[current_order];
-        g_allocator.buddy_free_lists[current_order] = buddy;
+
+    return NULL;
+}
+
+static buddy_arena_t *arena_for_ptr(void *ptr, int *node_out) {
+    for (int node = 0; node < g_allocator.numa_node_count; node++) {
+        buddy_arena_t *arena = &g_allocator.buddy_arenas[node];
+        if (arena->base && (char*)ptr >= (char*)arena->base &&
+            (char*)ptr < (char*)arena->base + arena->size) {
+            if (node_out) *node_out = node;
+            return arena;
+        }
     }
-    
-    node->free = 0;
-    g_allocator.stats.buddy_allocs++;
-    
-    return (char*)node + sizeof(buddy_node_t);
+    return NULL;
 }
 
 static void buddy_free(void *ptr) {
     if (!ptr) return;
-    
-    buddy_node_t *node = (buddy_node_t*)((char*)ptr - sizeof(buddy_node_t));
-    if (node->free) return; // Double free
-    
-    node->free = 1;
-    uint32_t order = node->order;
-    
-    // Try to merge with buddy
+
+    int node = 0;
+    buddy_arena_t *arena = arena_for_ptr(ptr, &node);
+    if (!arena) return;
+
+    buddy_node_t *blk = (buddy_node_t*)((char*)ptr - sizeof(buddy_node_t));
+    if (blk->free) return; // Double free
+
+    blk->free = 1;
+    uint32_t order = blk->order;
+    g_allocator.stats.node_usage[node] -= 1ULL << order;
+
+    // Try to merge with buddy (coalescing never crosses arenas)
     while (order < MAX_ORDER - 1) {
         size_t block_size = 1ULL << order;
-        uintptr_t block_addr = (uintptr_t)node;
-        uintptr_t buddy_addr = block_addr ^ block_size;
-        
-        // Check if buddy is within heap
-        if (buddy_addr < (uintptr_t)g_allocator.heap_base ||
-            buddy_addr >= (uintptr_t)g_allocator.heap_base + g_allocator.heap_size) {
+        uintptr_t block_addr = (uintptr_t)blk;
+        uintptr_t buddy_addr = ((block_addr - (uintptr_t)arena->base) ^ block_size) +
+                               (uintptr_t)arena->base;
+
+        // Check if buddy is within this arena
+        if (buddy_addr < (uintptr_t)arena->base ||
+            buddy_addr >= (uintptr_t)arena->base + arena->size) {
             break;
         }
-        
+
         buddy_node_t *buddy = (buddy_node_t*)buddy_addr;
         if (!buddy->free || buddy->order != order) break;
-        
+
         // Remove buddy from free list
-        buddy_node_t **list = &g_allocator.buddy_free_lists[order];
+        buddy_node_t **list = &arena->free_lists[order];
         while (*list && *list != buddy) {
             list = &(*list)->next;
         }
         if (*list) *list = buddy->next;
-        
+
         // Merge blocks
         if (buddy_addr < block_addr) {
-            node = buddy;
+            blk = buddy;
         }
-        
-        node->order = ++order;
+
+        blk->order = ++order;
     }
-    
+
     // Add to free list
-    node->next = g_allocator.buddy_free_lists[order];
-    g_allocator.buddy_free_lists[order] = node;
+    blk->next = arena->free_lists[order];
+    arena->free_lists[order] = blk;
+}
+
+static void buddy_init(void) {
+    g_allocator.numa_node_count = numa_node_count();
+    for (int node = 0; node < g_allocator.numa_node_count; node++) {
+        buddy_arena_init(&g_allocator.buddy_arenas[node], node);
+    }
+
+    size_t total = 0;
+    for (int node = 0; node < g_allocator.numa_node_count; node++) {
+        total += g_allocator.buddy_arenas[node].size;
+    }
+    g_allocator.stats.hugepage_coverage =
+        total ? (double)g_allocator.stats.hugepage_bytes / total : 0.0;
 }
 
 // Slab allocator implementation
@@ -323,69 +468,133 @@ static void slab_free(void *ptr, size_t size) {
     pthread_mutex_unlock(&cache->lock);
 }
 
-// Thread cache implementation
-static thread_cache_t *get_thread_cache(void) {
-    if (!thread_cache) {
-        thread_cache = calloc(1, sizeof(thread_cache_t));
+// Per-CPU magazine front end. The common alloc/free path is: claim this
+// CPU's loaded magazine with one atomic exchange, bump its count, publish
+// it back. No mutex is taken anywhere on that path; the slab locks only
+// see traffic when the depot runs dry and a whole magazine must be
+// (re)filled.
+
+static int size_class_for(size_t size) {
+    for (int i = 0; i < SLAB_SIZES_COUNT; i++) {
+        if (slab_sizes[i] >= size) return i;
     }
-    return thread_cache;
+    return -1;
 }
 
-static void *thread_cache_alloc(size_t size) {
-    thread_cache_t *cache = get_thread_cache();
-    if (!cache) return NULL;
-    
-    // Find appropriate cache index
-    int cache_idx = -1;
-    for (int i = 0; i < SLAB_SIZES_COUNT; i++) {
-        if (slab_sizes[i] >= size) {
-            cache_idx = i;
-            break;
+static void depot_push(depot_stack_t *stack, magazine_t *mag) {
+    depot_head_t old_head, new_head;
+    __atomic_load(&stack->head, &old_head, __ATOMIC_ACQUIRE);
+    do {
+        mag->next = old_head.top;
+        new_head.top = mag;
+        new_head.tag = old_head.tag + 1;
+    } while (!__atomic_compare_exchange(&stack->head, &old_head, &new_head, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+static magazine_t *depot_pop(depot_stack_t *stack) {
+    depot_head_t old_head, new_head;
+    __atomic_load(&stack->head, &old_head, __ATOMIC_ACQUIRE);
+    do {
+        if (!old_head.top) return NULL;
+        new_head.top = old_head.top->next;
+        new_head.tag = old_head.tag + 1;
+    } while (!__atomic_compare_exchange(&stack->head, &old_head, &new_head, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    return old_head.top;
+}
+
+static magazine_t *magazine_new(void) {
+    return calloc(1, sizeof(magazine_t));
+}
+
+static void *magazine_alloc(size_t size) {
+    int cache_idx = size_class_for(size);
+    if (cache_idx == -1) return NULL;
+
+    int cpu = sched_getcpu();
+    if (cpu < 0) cpu = 0;
+    cpu_magazine_t *slot = &g_allocator.cpu_magazines[cpu % MAX_CPUS][cache_idx];
+
+    // Fast path: claim the loaded magazine, take the top object, publish.
+    // The exchange leaves NULL in the slot, so a thread migrated onto this
+    // CPU mid-operation just falls through to the depot instead of racing.
+    magazine_t *mag = atomic_exchange_explicit(&slot->loaded, NULL,
+                                               memory_order_acquire);
+    if (mag) {
+        if (mag->count > 0) {
+            void *obj = mag->objs[--mag->count];
+            atomic_store_explicit(&slot->loaded, mag, memory_order_release);
+            slot->hits++;
+            return obj;
         }
+        // Drained: hand it to the empty depot and look for a full one
+        depot_push(&g_allocator.depot_empty[cache_idx], mag);
     }
-    
-    if (cache_idx == -1) return NULL;
-    
-    // Try thread-local cache first
-    void *obj = cache->free_lists[cache_idx];
-    if (obj) {
-        cache->free_lists[cache_idx] = *(void**)obj;
-        cache->cache_hits++;
-        cache->alloc_count++;
+    slot->misses++;
+
+    magazine_t *full = depot_pop(&g_allocator.depot_full[cache_idx]);
+    if (full) {
+        void *obj = full->objs[--full->count];
+
+        magazine_t *expected = NULL;
+        if (!atomic_compare_exchange_strong_explicit(&slot->loaded, &expected, full,
+                                                     memory_order_release,
+                                                     memory_order_relaxed)) {
+            // Someone reloaded the slot meanwhile; park the remainder
+            depot_push(full->count ? &g_allocator.depot_full[cache_idx]
+                                   : &g_allocator.depot_empty[cache_idx], full);
+        }
         return obj;
     }
-    
-    cache->cache_misses++;
+
+    // Cold path: central slab cache (the only place a lock exists)
     return slab_alloc(size);
 }
 
-static void thread_cache_free(void *ptr, size_t size) {
+static void magazine_free(void *ptr, size_t size) {
     if (!ptr) return;
-    
-    thread_cache_t *cache = get_thread_cache();
-    if (!cache) {
+
+    int cache_idx = size_class_for(size);
+    if (cache_idx == -1) {
         slab_free(ptr, size);
         return;
     }
-    
-    // Find appropriate cache index
-    int cache_idx = -1;
-    for (int i = 0; i < SLAB_SIZES_COUNT; i++) {
-        if (slab_sizes[i] >= size) {
-            cache_idx = i;
-            break;
+
+    int cpu = sched_getcpu();
+    if (cpu < 0) cpu = 0;
+    cpu_magazine_t *slot = &g_allocator.cpu_magazines[cpu % MAX_CPUS][cache_idx];
+
+    magazine_t *mag = atomic_exchange_explicit(&slot->loaded, NULL,
+                                               memory_order_acquire);
+    if (mag) {
+        if (mag->count < MAGAZINE_OBJS) {
+            mag->objs[mag->count++] = ptr;
+            atomic_store_explicit(&slot->loaded, mag, memory_order_release);
+            slot->hits++;
+            return;
         }
+        // Full magazine: swap it into the depot for other CPUs to drain
+        depot_push(&g_allocator.depot_full[cache_idx], mag);
     }
-    
-    if (cache_idx == -1) {
+    slot->misses++;
+
+    magazine_t *empty = depot_pop(&g_allocator.depot_empty[cache_idx]);
+    if (!empty) empty = magazine_new();
+    if (!empty) {
         slab_free(ptr, size);
         return;
     }
-    
-    // Add to thread-local cache
-    *(void**)ptr = cache->free_lists[cache_idx];
-    cache->free_lists[cache_idx] = ptr;
-    cache->free_count++;
+
+    empty->objs[0] = ptr;
+    empty->count = 1;
+
+    magazine_t *expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&slot->loaded, &expected, empty,
+                                                 memory_order_release,
+                                                 memory_order_relaxed)) {
+        depot_push(&g_allocator.depot_full[cache_idx], empty);
+    }
 }
 
 // High-level allocator interface
@@ -398,7 +607,7 @@ void *advanced_malloc(size_t size) {
     // Choose allocation strategy based on size
     if (size <= slab_sizes[SLAB_SIZES_COUNT - 1]) {
         // Use thread cache for small allocations
-        ptr = thread_cache_alloc(size);
+        ptr = magazine_alloc(size);
         if (!ptr) ptr = slab_alloc(size);
     } else if (size <= (1ULL << (MAX_ORDER - 1))) {
         // Use buddy allocator for medium allocations
@@ -453,7 +662,7 @@ void advanced_free(void *ptr) {
         g_allocator.stats.current_usage -= block->size;
     } else {
         // Small/medium allocation
-        thread_cache_free(ptr, 64); // Simplified - assume small allocation
+        magazine_free(ptr, 64); // Simplified - assume small allocation
     }
     
     g_allocator.stats.total_freed++;
@@ -477,17 +686,29 @@ void print_memory_stats(void) {
     printf("Slab allocations: %lu\n", stats.slab_allocs);
     printf("Large allocations: %lu\n", stats.large_allocs);
     printf("Average allocation time: %.2f cycles\n", stats.avg_alloc_time);
-    
-    // Thread cache statistics
-    if (thread_cache) {
-        printf("Thread cache hits: %lu\n", thread_cache->cache_hits);
-        printf("Thread cache misses: %lu\n", thread_cache->cache_misses);
-        if (thread_cache->cache_hits + thread_cache->cache_misses > 0) {
-            double hit_rate = (double)thread_cache->cache_hits / 
-                             (thread_cache->cache_hits + thread_cache->cache_misses) * 100.0;
-            printf("Thread cache hit rate: %.2f%%\n", hit_rate);
+
+    // NUMA / hugepage breakdown
+    for (int node = 0; node < g_allocator.numa_node_count; node++) {
+        printf("Node %d buddy usage: %lu bytes\n", node, stats.node_usage[node]);
+    }
+    printf("Hugepage-backed arena bytes: %lu (%.1f%% coverage)\n",
+           stats.hugepage_bytes, stats.hugepage_coverage * 100.0);
+
+
+    // Magazine front-end statistics, aggregated across CPUs
+    uint64_t mag_hits = 0, mag_misses = 0;
+    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+        for (int i = 0; i < SLAB_SIZES_COUNT; i++) {
+            mag_hits += g_allocator.cpu_magazines[cpu][i].hits;
+            mag_misses += g_allocator.cpu_magazines[cpu][i].misses;
         }
     }
+    printf("Magazine hits: %lu\n", mag_hits);
+    printf("Magazine misses: %lu\n", mag_misses);
+    if (mag_hits + mag_misses > 0) {
+        double hit_rate = (double)mag_hits / (mag_hits + mag_misses) * 100.0;
+        printf("Magazine hit rate: %.2f%%\n", hit_rate);
+    }
 }
 
 // Initialize allocator
@@ -517,15 +738,24 @@ void allocator_cleanup(void) {
     
     print_memory_stats();
     
-    // Free thread cache
-    if (thread_cache) {
-        free(thread_cache);
-        thread_cache = NULL;
+    // Release magazines parked in the per-CPU slots and the depots
+    for (int i = 0; i < SLAB_SIZES_COUNT; i++) {
+        for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+            magazine_t *mag = atomic_exchange(&g_allocator.cpu_magazines[cpu][i].loaded, NULL);
+            if (mag) free(mag);
+        }
+        magazine_t *mag;
+        while ((mag = depot_pop(&g_allocator.depot_full[i])) != NULL) free(mag);
+        while ((mag = depot_pop(&g_allocator.depot_empty[i])) != NULL) free(mag);
     }
-    
-    // Unmap buddy heap
-    if (g_allocator.heap_base) {
-        munmap(g_allocator.heap_base, g_allocator.heap_size);
+
+
+    // Unmap per-node buddy arenas
+    for (int node = 0; node < g_allocator.numa_node_count; node++) {
+        buddy_arena_t *arena = &g_allocator.buddy_arenas[node];
+        if (arena->base) {
+            munmap(arena->base, arena->size);
+        }
     }
     
     pthread_mutex_destroy(&g_allocator.global_lock);
@@ -29,6 +29,9 @@
 #define KERNEL_STACK_SIZE 8192
 #define MAX_OPEN_FILES 256
 #define SCHEDULER_QUANTUM_MS 10
+#define MAX_CPUS 8
+#define NUM_PRIORITIES 5
+#define LOAD_BALANCE_TICKS 100   // Rebalance every N scheduler ticks
 
 // Process states
 typedef enum {
@@ -91,6 +94,7 @@ typedef struct process {
     uint64_t time_slice;
     uint64_t cpu_time_used;
     uint64_t last_scheduled;
+    uint32_t cpu; // Home CPU
     
     // IPC
     struct process *waiting_for;
@@ -167,6 +171,21 @@ typedef struct interrupt {
     uint64_t count;
 } interrupt_t;
 
+// Per-CPU run queue. Each priority level keeps a FIFO list; the bitmap
+// has one bit per non-empty level, so pick-next is a single ctz. The
+// whole struct is cacheline-aligned so cores don't false-share, and the
+// spinlock is only contended when another core steals or balances.
+typedef struct cpu_runqueue {
+    volatile uint32_t lock;
+    uint32_t ready_bitmap;
+    uint32_t num_ready;
+    process_t *queue[NUM_PRIORITIES];
+    process_t *queue_tail[NUM_PRIORITIES];
+    process_t *current;
+    uint64_t switches;
+    uint64_t steals;
+} __attribute__((aligned(64))) cpu_runqueue_t;
+
 // Scheduler statistics
 typedef struct scheduler_stats {
     uint64_t context_switches;
@@ -182,11 +201,16 @@ typedef struct kernel_state {
     bool initialized;
     
     // Process management
-    process_t processes[MAX_PROCESSES];
-    thread_t threads[MAX_THREADS];
+    struct kmem_cache *process_cache;
+    struct kmem_cache *thread_cache;
+    struct kmem_cache *file_cache;
+    thread_t *thread_list; // All live threads, for timer wakeups
+    uint32_t num_processes;
+    uint32_t num_threads;
     process_t *current_process;
     thread_t *current_thread;
-    process_t *ready_queue[5]; // One per priority level
+    cpu_runqueue_t runqueues[MAX_CPUS]; // Per-CPU ready queues
+    uint32_t next_cpu; // Round-robin placement of new processes
     uint32_t next_pid;
     uint32_t next_tid;
     
@@ -198,7 +222,6 @@ typedef struct kernel_state {
     
     // File systems
     filesystem_t *filesystems;
-    file_t file_table[MAX_OPEN_FILES * MAX_PROCESSES];
     
     // Devices
     device_t *devices;
@@ -233,6 +256,126 @@ static inline void enable_interrupts(void) {
     __asm__ volatile ("sti" : : : "memory");
 }
 
+// Run queue spinlock (only contended by stealing/balancing cores)
+static inline void rq_lock(cpu_runqueue_t *rq) {
+    while (__sync_lock_test_and_set(&rq->lock, 1)) {
+        __asm__ volatile ("pause");
+    }
+}
+
+static inline void rq_unlock(cpu_runqueue_t *rq) {
+    __sync_lock_release(&rq->lock);
+}
+
+// Enqueue at the tail of the priority's FIFO; caller holds the lock
+static void rq_enqueue(cpu_runqueue_t *rq, process_t *proc) {
+    priority_t prio = proc->priority;
+
+    proc->next = NULL;
+    if (rq->queue_tail[prio]) {
+        rq->queue_tail[prio]->next = proc;
+    } else {
+        rq->queue[prio] = proc;
+    }
+    rq->queue_tail[prio] = proc;
+
+    rq->ready_bitmap |= 1u << prio;
+    rq->num_ready++;
+}
+
+// O(1) pick-next: ctz of the bitmap gives the best non-empty level;
+// caller holds the lock
+static process_t *rq_dequeue(cpu_runqueue_t *rq) {
+    if (rq->ready_bitmap == 0) {
+        return NULL;
+    }
+
+    uint32_t prio = __builtin_ctz(rq->ready_bitmap);
+    process_t *proc = rq->queue[prio];
+
+    rq->queue[prio] = proc->next;
+    if (!rq->queue[prio]) {
+        rq->queue_tail[prio] = NULL;
+        rq->ready_bitmap &= ~(1u << prio);
+    }
+    rq->num_ready--;
+
+    proc->next = NULL;
+    return proc;
+}
+
+// Place a ready process on its home CPU's queue
+static void enqueue_process(process_t *proc) {
+    cpu_runqueue_t *rq = &g_kernel.runqueues[proc->cpu];
+
+    rq_lock(rq);
+    rq_enqueue(rq, proc);
+    rq_unlock(rq);
+}
+
+// Idle stealing: take one process from the busiest other queue
+static process_t *steal_process(uint32_t this_cpu) {
+    uint32_t busiest = this_cpu;
+    uint32_t max_ready = 0;
+
+    for (uint32_t cpu = 0; cpu < g_kernel.num_cpus; cpu++) {
+        if (cpu != this_cpu && g_kernel.runqueues[cpu].num_ready > max_ready) {
+            max_ready = g_kernel.runqueues[cpu].num_ready;
+            busiest = cpu;
+        }
+    }
+
+    if (busiest == this_cpu) {
+        return NULL;
+    }
+
+    cpu_runqueue_t *victim = &g_kernel.runqueues[busiest];
+    rq_lock(victim);
+    process_t *proc = rq_dequeue(victim);
+    rq_unlock(victim);
+
+    if (proc) {
+        proc->cpu = this_cpu;
+        g_kernel.runqueues[this_cpu].steals++;
+    }
+    return proc;
+}
+
+// Periodic balancing: if this queue is at least two processes ahead of
+// the emptiest one, migrate the difference's worth of work over
+static void load_balance(uint32_t this_cpu) {
+    cpu_runqueue_t *rq = &g_kernel.runqueues[this_cpu];
+    uint32_t emptiest = this_cpu;
+
+    for (uint32_t cpu = 0; cpu < g_kernel.num_cpus; cpu++) {
+        if (g_kernel.runqueues[cpu].num_ready <
+            g_kernel.runqueues[emptiest].num_ready) {
+            emptiest = cpu;
+        }
+    }
+
+    cpu_runqueue_t *target = &g_kernel.runqueues[emptiest];
+    if (emptiest == this_cpu ||
+        rq->num_ready < target->num_ready + 2) {
+        return;
+    }
+
+    uint32_t to_move = (rq->num_ready - target->num_ready) / 2;
+    while (to_move--) {
+        rq_lock(rq);
+        process_t *proc = rq_dequeue(rq);
+        rq_unlock(rq);
+        if (!proc) {
+            break;
+        }
+
+        proc->cpu = emptiest;
+        rq_lock(target);
+        rq_enqueue(target, proc);
+        rq_unlock(target);
+    }
+}
+
 // Memory management
 static uint64_t alloc_page(void) {
     // Simplified page allocation
@@ -252,6 +395,181 @@ static void free_page(uint64_t page) {
     g_kernel.free_memory += PAGE_SIZE;
 }
 
+// Slab allocator
+//
+// Kernel objects are sub-100-byte structs, so handing out whole pages
+// per object is wasted work on fork/exec paths. A cache carves one
+// page into cache-line-aligned objects. Each CPU keeps its own
+// partial-slab list to limit contention, but free-list surgery is
+// guarded by the per-cache spinlock: an object is routinely freed on a
+// different CPU than it was allocated on (exit vs fork). Objects are
+// zeroed and re-constructed on every alloc — the free-list link and
+// whatever the previous owner left behind must not leak into the next
+// user.
+
+#define SLAB_ALIGN 64            // Objects never share a cache line
+#define MAX_KMEM_CACHES 16
+#define CACHE_NAME_LEN 16
+
+typedef struct slab {
+    struct slab *next;
+    struct kmem_cache *cache;
+    uint32_t in_use;
+    void *free_list;             // Threaded through free objects
+} slab_t;
+
+typedef struct kmem_cache_cpu {
+    slab_t *partial;             // Slabs with free objects, this CPU only
+    uint64_t allocs;
+    uint64_t frees;
+} __attribute__((aligned(64))) kmem_cache_cpu_t;
+
+typedef struct kmem_cache {
+    char name[CACHE_NAME_LEN];
+    uint32_t object_size;        // Rounded up to SLAB_ALIGN
+    uint32_t objects_per_slab;
+    void (*ctor)(void *obj);
+    kmem_cache_cpu_t cpu[MAX_CPUS];
+    slab_t *full;                // Shared; guarded by lock
+    volatile uint32_t lock;
+    uint32_t num_slabs;
+    struct kmem_cache *next;
+} kmem_cache_t;
+
+static kmem_cache_t g_cache_pool[MAX_KMEM_CACHES];
+static uint32_t g_num_caches;
+static kmem_cache_t *g_cache_list;
+
+static inline void cache_lock(kmem_cache_t *cache) {
+    while (__sync_lock_test_and_set(&cache->lock, 1)) {
+        __asm__ volatile ("pause");
+    }
+}
+
+static inline void cache_unlock(kmem_cache_t *cache) {
+    __sync_lock_release(&cache->lock);
+}
+
+kmem_cache_t *kmem_cache_create(const char *name, uint32_t size,
+                                void (*ctor)(void *obj)) {
+    if (g_num_caches >= MAX_KMEM_CACHES) {
+        return NULL;
+    }
+
+    kmem_cache_t *cache = &g_cache_pool[g_num_caches++];
+    memset(cache, 0, sizeof(kmem_cache_t));
+    strncpy(cache->name, name, CACHE_NAME_LEN - 1);
+
+    // Cache-line-aligned objects; slab header occupies the page head
+    cache->object_size = (size + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1);
+    uint32_t header = (sizeof(slab_t) + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1);
+    cache->objects_per_slab = (PAGE_SIZE - header) / cache->object_size;
+    cache->ctor = ctor;
+
+    cache->next = g_cache_list;
+    g_cache_list = cache;
+    return cache;
+}
+
+// Carve a fresh page into objects and thread the free list through
+// them. Construction happens at alloc time, after the object is zeroed.
+static slab_t *kmem_cache_grow(kmem_cache_t *cache) {
+    slab_t *slab = (slab_t *)alloc_page();
+    if (!slab) {
+        return NULL;
+    }
+
+    slab->next = NULL;
+    slab->cache = cache;
+    slab->in_use = 0;
+    slab->free_list = NULL;
+
+    uint32_t header = (sizeof(slab_t) + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1);
+    uint8_t *obj = (uint8_t *)slab + header;
+
+    for (uint32_t i = 0; i < cache->objects_per_slab; i++) {
+        *(void **)obj = slab->free_list;
+        slab->free_list = obj;
+        obj += cache->object_size;
+    }
+
+    cache->num_slabs++;
+    return slab;
+}
+
+void *kmem_cache_alloc(kmem_cache_t *cache) {
+    kmem_cache_cpu_t *cpu = &cache->cpu[g_kernel.current_cpu];
+
+    cache_lock(cache);
+
+    slab_t *slab = cpu->partial;
+    if (!slab) {
+        slab = kmem_cache_grow(cache);
+        if (!slab) {
+            cache_unlock(cache);
+            return NULL;
+        }
+        cpu->partial = slab;
+    }
+
+    void *obj = slab->free_list;
+    slab->free_list = *(void **)obj;
+    slab->in_use++;
+    cpu->allocs++;
+
+    // Slab exhausted: park it on the shared full list
+    if (!slab->free_list) {
+        cpu->partial = slab->next;
+        slab->next = cache->full;
+        cache->full = slab;
+    }
+
+    cache_unlock(cache);
+
+    // Hand out a clean object: the free-list link clobbered the first
+    // word and the previous owner's state must not leak to the next
+    memset(obj, 0, cache->object_size);
+    if (cache->ctor) {
+        cache->ctor(obj);
+    }
+
+    return obj;
+}
+
+void kmem_cache_free(kmem_cache_t *cache, void *obj) {
+    // The slab header lives at the start of the object's page
+    slab_t *slab = (slab_t *)((uint64_t)obj & ~((uint64_t)PAGE_SIZE - 1));
+
+    // The whole free path runs under the cache lock: the slab may be
+    // another CPU's partial head, and a concurrent alloc is popping
+    // from the same free list
+    cache_lock(cache);
+
+    bool was_full = (slab->free_list == NULL);
+
+    *(void **)obj = slab->free_list;
+    slab->free_list = obj;
+    slab->in_use--;
+    cache->cpu[g_kernel.current_cpu].frees++;
+
+    // First free object: pull it off the full list back to this CPU
+    if (was_full) {
+        slab_t **link = &cache->full;
+        while (*link && *link != slab) {
+            link = &(*link)->next;
+        }
+        if (*link) {
+            *link = slab->next;
+        }
+
+        kmem_cache_cpu_t *cpu = &cache->cpu[g_kernel.current_cpu];
+        slab->next = cpu->partial;
+        cpu->partial = slab;
+    }
+
+    cache_unlock(cache);
+}
+
 // Virtual memory mapping
 static bool map_page(uint64_t virtual_addr, uint64_t physical_addr, uint32_t flags) {
     // Simplified page table mapping
@@ -271,23 +589,22 @@ static bool map_page(uint64_t virtual_addr, uint64_t physical_addr, uint32_t fla
 // Process creation
 process_t *create_process(const char *name, void *entry_point, priority_t priority) {
     disable_interrupts();
-    
-    // Find free process slot
-    process_t *proc = NULL;
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (g_kernel.processes[i].state == PROCESS_TERMINATED) {
-            proc = &g_kernel.processes[i];
-            break;
-        }
+
+    // Check the table limit before touching the slab so a refused
+    // creation never strands an allocated object
+    if (g_kernel.num_processes >= MAX_PROCESSES) {
+        enable_interrupts();
+        return NULL;
     }
-    
+
+    // Objects come out of the slab zeroed and freshly constructed
+    process_t *proc = kmem_cache_alloc(g_kernel.process_cache);
     if (!proc) {
         enable_interrupts();
         return NULL;
     }
-    
-    // Initialize process
-    memset(proc, 0, sizeof(process_t));
+
+    g_kernel.num_processes++;
     proc->pid = g_kernel.next_pid++;
     proc->ppid = g_kernel.current_process ? g_kernel.current_process->pid : 0;
     proc->state = PROCESS_READY;
@@ -315,10 +632,11 @@ process_t *create_process(const char *name, void *entry_point, priority_t priori
         proc->open_files[i] = NULL;
     }
     
-    // Add to ready queue
-    proc->next = g_kernel.ready_queue[priority];
-    g_kernel.ready_queue[priority] = proc;
-    
+    // Place on a CPU round-robin; it stays sticky until balanced/stolen
+    proc->cpu = g_kernel.next_cpu;
+    g_kernel.next_cpu = (g_kernel.next_cpu + 1) % g_kernel.num_cpus;
+    enqueue_process(proc);
+
     enable_interrupts();
     return proc;
 }
@@ -326,23 +644,19 @@ process_t *create_process(const char *name, void *entry_point, priority_t priori
 // Thread creation
 thread_t *create_thread(process_t *process, void *entry_point, void *arg) {
     disable_interrupts();
-    
-    // Find free thread slot
-    thread_t *thread = NULL;
-    for (int i = 0; i < MAX_THREADS; i++) {
-        if (g_kernel.threads[i].state == PROCESS_TERMINATED) {
-            thread = &g_kernel.threads[i];
-            break;
-        }
+
+    if (g_kernel.num_threads >= MAX_THREADS) {
+        enable_interrupts();
+        return NULL;
     }
-    
+
+    thread_t *thread = kmem_cache_alloc(g_kernel.thread_cache);
     if (!thread) {
         enable_interrupts();
         return NULL;
     }
-    
-    // Initialize thread
-    memset(thread, 0, sizeof(thread_t));
+
+    g_kernel.num_threads++;
     thread->tid = g_kernel.next_tid++;
     thread->pid = process->pid;
     thread->state = PROCESS_READY;
@@ -358,7 +672,11 @@ thread_t *create_thread(process_t *process, void *entry_point, void *arg) {
     thread->context.rdi = (uint64_t)arg; // First argument
     thread->context.rflags = 0x202;
     thread->context.cr3 = process->page_directory;
-    
+
+    // Track for timer wakeups
+    thread->next = g_kernel.thread_list;
+    g_kernel.thread_list = thread;
+
     enable_interrupts();
     return thread;
 }
@@ -410,54 +728,59 @@ void switch_context(cpu_context_t *old_context, cpu_context_t *new_context) {
     );
 }
 
-// Scheduler - Round-robin with priority queues
+// Scheduler - per-CPU priority queues with O(1) pick-next
 void schedule(void) {
     disable_interrupts();
-    
+
     uint64_t current_time = get_timestamp();
-    process_t *next_process = NULL;
-    
-    // Find highest priority process
-    for (int priority = 0; priority < 5; priority++) {
-        if (g_kernel.ready_queue[priority]) {
-            next_process = g_kernel.ready_queue[priority];
-            g_kernel.ready_queue[priority] = next_process->next;
-            break;
-        }
+    uint32_t this_cpu = g_kernel.current_cpu;
+    cpu_runqueue_t *rq = &g_kernel.runqueues[this_cpu];
+
+    // Pick the highest-priority ready process on this CPU
+    rq_lock(rq);
+    process_t *next_process = rq_dequeue(rq);
+    rq_unlock(rq);
+
+    // Nothing local: try to steal from the busiest other CPU
+    if (!next_process) {
+        next_process = steal_process(this_cpu);
     }
-    
+
     if (!next_process) {
         // No process to run, idle
         enable_interrupts();
         __asm__ volatile ("hlt");
         return;
     }
-    
-    process_t *old_process = g_kernel.current_process;
-    
+
+    process_t *old_process = rq->current;
+
     // Update scheduler statistics
     if (old_process) {
         old_process->cpu_time_used += current_time - old_process->last_scheduled;
-        
-        // Put back in ready queue if still runnable
+
+        // Put back on this CPU's queue if still runnable
         if (old_process->state == PROCESS_RUNNING) {
             old_process->state = PROCESS_READY;
-            old_process->next = g_kernel.ready_queue[old_process->priority];
-            g_kernel.ready_queue[old_process->priority] = old_process;
+            rq_lock(rq);
+            rq_enqueue(rq, old_process);
+            rq_unlock(rq);
         }
     }
-    
+
     // Switch to new process
+    rq->current = next_process;
+    rq->switches++;
     g_kernel.current_process = next_process;
     next_process->state = PROCESS_RUNNING;
     next_process->last_scheduled = current_time;
     g_kernel.scheduler_stats.context_switches++;
-    
+
     // Perform context switch
     if (old_process && old_process != next_process) {
         switch_context(&old_process->context, &next_process->context);
     }
-    
+
     enable_interrupts();
 }
 
@@ -469,12 +792,16 @@ void timer_interrupt_handler(uint32_t irq, void *context) {
     if (g_kernel.scheduler_ticks % SCHEDULER_QUANTUM_MS == 0) {
         schedule();
     }
+
+    // Periodically even out the per-CPU queues
+    if (g_kernel.scheduler_ticks % LOAD_BALANCE_TICKS == 0) {
+        load_balance(g_kernel.current_cpu);
+    }
     
     // Wake up sleeping processes
-    for (int i = 0; i < MAX_THREADS; i++) {
-        thread_t *thread = &g_kernel.threads[i];
-        if (thread->state == PROCESS_BLOCKED && 
-            thread->wakeup_time && 
+    for (thread_t *thread = g_kernel.thread_list; thread; thread = thread->next) {
+        if (thread->state == PROCESS_BLOCKED &&
+            thread->wakeup_time &&
             get_timestamp() >= thread->wakeup_time) {
             thread->state = PROCESS_READY;
             thread->wakeup_time = 0;
@@ -550,8 +877,10 @@ int sys_open(const char *path, int flags) {
     }
     
     // For simplicity, create a dummy file
-    file_t *file = &g_kernel.file_table[fd];
-    memset(file, 0, sizeof(file_t));
+    file_t *file = kmem_cache_alloc(g_kernel.file_cache);
+    if (!file) {
+        return -1;
+    }
     file->inode = 1;
     file->offset = 0;
     file->flags = flags;
@@ -577,8 +906,12 @@ int sys_close(int fd) {
         if (file->fs && file->fs->close) {
             file->fs->close(file);
         }
+
+        // Return to the cache in constructed (zeroed) state
+        memset(file, 0, sizeof(file_t));
+        kmem_cache_free(g_kernel.file_cache, file);
     }
-    
+
     g_kernel.current_process->open_files[fd] = NULL;
     return 0;
 }
@@ -640,11 +973,25 @@ void sys_exit(int exit_code) {
     }
     
     // Schedule next process
+    g_kernel.runqueues[process->cpu].current = NULL;
     g_kernel.current_process = NULL;
     enable_interrupts();
     schedule();
 }
 
+// Cache constructors
+static void kobj_zero_ctor_process(void *obj) {
+    memset(obj, 0, sizeof(process_t));
+}
+
+static void kobj_zero_ctor_thread(void *obj) {
+    memset(obj, 0, sizeof(thread_t));
+}
+
+static void kobj_zero_ctor_file(void *obj) {
+    memset(obj, 0, sizeof(file_t));
+}
+
 // Kernel statistics
 void print_kernel_stats(void) {
     printf("Kernel Statistics:\n");
@@ -654,6 +1001,23 @@ void print_kernel_stats(void) {
     printf("Memory usage: %lu KB / %lu KB\n", 
            g_kernel.used_memory / 1024, g_kernel.total_memory / 1024);
     printf("Scheduler ticks: %lu\n", g_kernel.scheduler_ticks);
+
+    for (uint32_t cpu = 0; cpu < g_kernel.num_cpus; cpu++) {
+        cpu_runqueue_t *rq = &g_kernel.runqueues[cpu];
+        printf("CPU %u: %u ready, %lu switches, %lu steals\n",
+               cpu, rq->num_ready, rq->switches, rq->steals);
+    }
+
+    for (kmem_cache_t *cache = g_cache_list; cache; cache = cache->next) {
+        uint64_t allocs = 0, frees = 0;
+        for (uint32_t cpu = 0; cpu < MAX_CPUS; cpu++) {
+            allocs += cache->cpu[cpu].allocs;
+            frees += cache->cpu[cpu].frees;
+        }
+        printf("Cache %s: %u B objects, %u slabs, %lu allocs, %lu frees\n",
+               cache->name, cache->object_size, cache->num_slabs,
+               allocs, frees);
+    }
     
     if (g_kernel.scheduler_stats.context_switches > 0) {
         printf("Average response time: %.2f μs\n", 
@@ -678,24 +1042,25 @@ bool init_kernel(void) {
     
     // Allocate page directory
     g_kernel.page_directory = (uint64_t*)alloc_page();
-    
-    // Initialize process/thread tables
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        g_kernel.processes[i].state = PROCESS_TERMINATED;
-    }
-    
-    for (int i = 0; i < MAX_THREADS; i++) {
-        g_kernel.threads[i].state = PROCESS_TERMINATED;
-    }
-    
-    // Initialize ready queues
-    for (int i = 0; i < 5; i++) {
-        g_kernel.ready_queue[i] = NULL;
+
+    // Object caches: constructors establish the zeroed state once per
+    // object; recycled objects come back already constructed
+    g_kernel.process_cache = kmem_cache_create("process", sizeof(process_t),
+                                               kobj_zero_ctor_process);
+    g_kernel.thread_cache = kmem_cache_create("thread", sizeof(thread_t),
+                                              kobj_zero_ctor_thread);
+    g_kernel.file_cache = kmem_cache_create("file", sizeof(file_t),
+                                            kobj_zero_ctor_file);
+    if (!g_kernel.process_cache || !g_kernel.thread_cache ||
+        !g_kernel.file_cache) {
+        return false;
     }
-    
+
+    // Per-CPU run queues start empty (zeroed above)
     g_kernel.next_pid = 1;
     g_kernel.next_tid = 1;
-    g_kernel.num_cpus = 1; // Single CPU for now
+    g_kernel.num_cpus = MAX_CPUS;
+    g_kernel.next_cpu = 0;
     
     // Setup timer interrupt
     g_kernel.interrupts[0].irq = 0;
@@ -24,24 +24,105 @@
 #include <linux/udp.h>
 #include <linux/icmp.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
 #include <pthread.h>
 #include <immintrin.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 // Global stack configuration
 static tcp_stack_config_t g_stack_config;
 static tcp_stack_stats_t g_stack_stats;
 
 // Lock-free ring buffer for packet queues
+//
+// Multi-producer/multi-consumer: every cell carries a sequence number
+// (Vyukov scheme) so several NIC queues can steer into the same core
+// ring without a lock, and head/tail live on separate cache lines to
+// avoid producer/consumer ping-pong.
 typedef struct {
-    volatile uint32_t head;
-    volatile uint32_t tail;
+    volatile uint32_t seq;
+    packet_buffer_t *packet;
+} ring_cell_t;
+
+typedef struct {
+    volatile uint32_t head __attribute__((aligned(64)));  // producers
+    volatile uint32_t tail __attribute__((aligned(64)));  // consumers
     uint32_t size;
     uint32_t mask;
-    packet_buffer_t *packets;
+    ring_cell_t *cells;
 } __attribute__((aligned(64))) ring_buffer_t;
 
-// Per-CPU packet processing queues
-static __thread ring_buffer_t rx_queue;
+#define RING_DEFAULT_SIZE 4096
+
+static int ring_buffer_init(ring_buffer_t *ring, uint32_t size) {
+    ring->cells = calloc(size, sizeof(ring_cell_t));
+    if (!ring->cells) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        ring->cells[i].seq = i;
+    }
+    ring->size = size;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    return 0;
+}
+
+static inline int ring_mp_enqueue(ring_buffer_t *ring, packet_buffer_t *packet) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    for (;;) {
+        ring_cell_t *cell = &ring->cells[head & ring->mask];
+        uint32_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - head);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->head, &head, head + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                cell->packet = packet;
+                __atomic_store_n(&cell->seq, head + 1, __ATOMIC_RELEASE);
+                return 0;
+            }
+        } else if (diff < 0) {
+            return -1;  // Ring full
+        } else {
+            head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static inline packet_buffer_t *ring_mc_dequeue(ring_buffer_t *ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    for (;;) {
+        ring_cell_t *cell = &ring->cells[tail & ring->mask];
+        uint32_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - (tail + 1));
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &tail, tail + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                packet_buffer_t *packet = cell->packet;
+                __atomic_store_n(&cell->seq, tail + ring->size, __ATOMIC_RELEASE);
+                return packet;
+            }
+        } else if (diff < 0) {
+            return NULL;  // Ring empty
+        } else {
+            tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// RSS: per-core RX rings. Ingress hashes the 4-tuple and steers each
+// flow to a fixed ring, so a connection is always processed on the same
+// core and its tcp_connection_t stays cache-hot there.
+#define MAX_RX_QUEUES 16
+
+static ring_buffer_t rx_rings[MAX_RX_QUEUES];
+static uint32_t num_rx_queues;
+
+// Per-CPU TX queue (initialized on first use)
 static __thread ring_buffer_t tx_queue;
 
 // Memory pool for packet buffers
@@ -50,9 +131,102 @@ static volatile uint32_t pool_head = 0;
 static uint32_t pool_size;
 
 // TCP connection hash table
+//
+// RCU-style: the per-packet lookup path never takes a lock. Readers
+// announce themselves by publishing the global epoch into a per-thread
+// slot; writers (connect/teardown only) serialize on one mutex, publish
+// list updates with release stores, and wait for every in-flight reader
+// to leave its critical section before freeing an unlinked connection.
 #define TCP_HASH_SIZE 65536
 static tcp_connection_t *tcp_hash_table[TCP_HASH_SIZE];
-static pthread_rwlock_t tcp_hash_locks[TCP_HASH_SIZE];
+
+#define RCU_MAX_THREADS 64
+
+typedef struct {
+    volatile uint64_t epoch;   // 0 = not in a read-side section
+    volatile int in_use;       // claimed by a live thread
+} __attribute__((aligned(64))) rcu_reader_t;
+
+static rcu_reader_t rcu_readers[RCU_MAX_THREADS];
+static volatile uint64_t rcu_global_epoch = 1;
+static __thread int rcu_reader_slot = -1;
+
+static pthread_mutex_t tcp_hash_write_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// A thread past the RCU_MAX_THREADS slots falls back to serializing
+// against writers on the hash mutex for that read-side section
+#define RCU_SLOT_FALLBACK (-2)
+
+static pthread_key_t rcu_slot_key;
+static pthread_once_t rcu_slot_key_once = PTHREAD_ONCE_INIT;
+
+// Thread exit: release the slot so a later thread can claim it
+static void rcu_release_slot(void *arg) {
+    rcu_reader_t *reader = arg;
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&reader->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void rcu_slot_key_init(void) {
+    pthread_key_create(&rcu_slot_key, rcu_release_slot);
+}
+
+static int rcu_claim_slot(void) {
+    pthread_once(&rcu_slot_key_once, rcu_slot_key_init);
+    for (int i = 0; i < RCU_MAX_THREADS; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&rcu_readers[i].in_use, &expected, 1,
+                                        false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            pthread_setspecific(rcu_slot_key, &rcu_readers[i]);
+            return i;
+        }
+    }
+    return RCU_SLOT_FALLBACK;
+}
+
+// Enter a read-side critical section. The connection returned by
+// find_tcp_connection is only guaranteed alive until the matching
+// tcp_rcu_read_unlock.
+static inline void tcp_rcu_read_lock(void) {
+    if (rcu_reader_slot < 0) {
+        rcu_reader_slot = rcu_claim_slot();
+    }
+    if (rcu_reader_slot == RCU_SLOT_FALLBACK) {
+        // No free slot: hold the writer mutex instead. An unlink cannot
+        // run concurrently, so the walk stays safe — just not wait-free.
+        pthread_mutex_lock(&tcp_hash_write_lock);
+        return;
+    }
+    uint64_t epoch = __atomic_load_n(&rcu_global_epoch, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&rcu_readers[rcu_reader_slot].epoch, epoch, __ATOMIC_SEQ_CST);
+}
+
+static inline void tcp_rcu_read_unlock(void) {
+    if (rcu_reader_slot == RCU_SLOT_FALLBACK) {
+        rcu_reader_slot = -1;  // a slot may have been released; retry next time
+        pthread_mutex_unlock(&tcp_hash_write_lock);
+        return;
+    }
+    __atomic_store_n(&rcu_readers[rcu_reader_slot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+// Writer-side: wait until every reader that might still see an unlinked
+// connection has left its critical section. Scans every slot: claimed
+// ones may belong to threads that died mid-section, and released ones
+// report epoch 0.
+static void tcp_rcu_synchronize(void) {
+    uint64_t new_epoch = __atomic_add_fetch(&rcu_global_epoch, 1, __ATOMIC_SEQ_CST);
+
+    for (uint32_t i = 0; i < RCU_MAX_THREADS; i++) {
+        while (1) {
+            uint64_t epoch = __atomic_load_n(&rcu_readers[i].epoch, __ATOMIC_ACQUIRE);
+            if (epoch == 0 || epoch >= new_epoch) {
+                break;  // Reader is out, or entered after the unlink
+            }
+            _mm_pause();
+        }
+    }
+}
 
 // Initialize the TCP/IP stack
 int tcp_stack_init(const tcp_stack_config_t *config) {
@@ -76,12 +250,21 @@ int tcp_stack_init(const tcp_stack_config_t *config) {
     }
     packet_pool[pool_size - 1].next = NULL;
     
-    // Initialize hash table locks
+    // Initialize hash table
     for (int i = 0; i < TCP_HASH_SIZE; i++) {
-        pthread_rwlock_init(&tcp_hash_locks[i], NULL);
         tcp_hash_table[i] = NULL;
     }
-    
+
+    // One RX ring per online core, capped at MAX_RX_QUEUES
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    num_rx_queues = (cores > 0 && cores < MAX_RX_QUEUES) ? (uint32_t)cores
+                                                         : MAX_RX_QUEUES;
+    for (uint32_t q = 0; q < num_rx_queues; q++) {
+        if (ring_buffer_init(&rx_rings[q], RING_DEFAULT_SIZE) < 0) {
+            return -1;
+        }
+    }
+
     return 0;
 }
 
@@ -205,26 +388,56 @@ static inline uint32_t tcp_connection_hash(uint32_t src_ip, uint16_t src_port,
     return (key >> 32) & (TCP_HASH_SIZE - 1);
 }
 
-// Find TCP connection
+// Find TCP connection. Wait-free: walks the bucket chain with acquire
+// loads only. Caller must be inside tcp_rcu_read_lock/unlock and must
+// not use the result after unlocking.
 static tcp_connection_t *find_tcp_connection(uint32_t src_ip, uint16_t src_port,
                                            uint32_t dst_ip, uint16_t dst_port) {
     uint32_t hash = tcp_connection_hash(src_ip, src_port, dst_ip, dst_port);
-    
-    pthread_rwlock_rdlock(&tcp_hash_locks[hash]);
-    
-    tcp_connection_t *conn = tcp_hash_table[hash];
+
+    tcp_connection_t *conn = __atomic_load_n(&tcp_hash_table[hash], __ATOMIC_ACQUIRE);
     while (conn) {
         if (conn->src_ip == src_ip && conn->src_port == src_port &&
             conn->dst_ip == dst_ip && conn->dst_port == dst_port) {
             break;
         }
-        conn = conn->hash_next;
+        conn = __atomic_load_n(&conn->hash_next, __ATOMIC_ACQUIRE);
     }
-    
-    pthread_rwlock_unlock(&tcp_hash_locks[hash]);
+
     return conn;
 }
 
+// Insert a connection (connect/accept path). New node is fully
+// initialized before the release store makes it visible to readers.
+void tcp_connection_insert(tcp_connection_t *conn) {
+    uint32_t hash = tcp_connection_hash(conn->src_ip, conn->src_port,
+                                        conn->dst_ip, conn->dst_port);
+
+    pthread_mutex_lock(&tcp_hash_write_lock);
+    conn->hash_next = tcp_hash_table[hash];
+    __atomic_store_n(&tcp_hash_table[hash], conn, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&tcp_hash_write_lock);
+}
+
+// Remove a connection (teardown path). Unlinks, then waits out all
+// in-flight readers before the node can be freed or recycled.
+void tcp_connection_remove(tcp_connection_t *conn) {
+    uint32_t hash = tcp_connection_hash(conn->src_ip, conn->src_port,
+                                        conn->dst_ip, conn->dst_port);
+
+    pthread_mutex_lock(&tcp_hash_write_lock);
+    tcp_connection_t **link = &tcp_hash_table[hash];
+    while (*link && *link != conn) {
+        link = &(*link)->hash_next;
+    }
+    if (*link) {
+        __atomic_store_n(link, conn->hash_next, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&tcp_hash_write_lock);
+
+    tcp_rcu_synchronize();
+}
+
 // TCP state machine
 static int tcp_state_machine(tcp_connection_t *conn, struct tcphdr *tcp_hdr,
                             packet_buffer_t *packet) {
@@ -311,24 +524,30 @@ static int process_tcp_packet(packet_buffer_t *packet) {
         }
     }
     
-    // Find connection
+    // Find connection; hold the read-side section across the state
+    // machine so a concurrent teardown cannot free it under us
+    tcp_rcu_read_lock();
+
     tcp_connection_t *conn = find_tcp_connection(
         ntohl(ip_hdr->saddr), ntohs(tcp_hdr->source),
         ntohl(ip_hdr->daddr), ntohs(tcp_hdr->dest));
-    
+
     if (!conn) {
         // No connection found, check for listening socket
         conn = find_listening_socket(ntohs(tcp_hdr->dest));
         if (!conn) {
+            tcp_rcu_read_unlock();
             // Send RST
             send_tcp_rst(packet);
             return -1;
         }
     }
-    
+
     // Process through state machine
     tcp_state_machine(conn, tcp_hdr, packet);
-    
+
+    tcp_rcu_read_unlock();
+
     g_stack_stats.tcp_packets_processed++;
     return 0;
 }
@@ -379,25 +598,346 @@ drop_packet:
     return -1;
 }
 
+// Symmetric RSS hash over the 4-tuple: src/dst are XOR-folded so both
+// directions of a flow steer to the same ring
+static inline uint32_t rss_queue_for_packet(const packet_buffer_t *packet) {
+    const struct ethhdr *eth_hdr = (const struct ethhdr *)packet->data;
+    if (ntohs(eth_hdr->h_proto) != ETH_P_IP) {
+        return 0;  // Non-IP traffic on queue 0
+    }
+
+    const struct iphdr *ip_hdr = (const struct iphdr *)(packet->data + ETH_HLEN);
+    uint64_t key = (uint64_t)(ip_hdr->saddr ^ ip_hdr->daddr) << 32;
+
+    if (ip_hdr->protocol == IPPROTO_TCP || ip_hdr->protocol == IPPROTO_UDP) {
+        const uint16_t *ports =
+            (const uint16_t *)((const uint8_t *)ip_hdr + ip_hdr->ihl * 4);
+        key |= (uint16_t)(ports[0] ^ ports[1]);
+    }
+
+    key *= 0x9e3779b97f4a7c15ULL;
+    return (uint32_t)(key >> 32) % num_rx_queues;
+}
+
+// Ingress dispatch: steer a received frame to its flow's RX ring. Safe
+// to call from any number of NIC/polling threads concurrently.
+int tcp_stack_rx_dispatch(packet_buffer_t *packet) {
+    uint32_t queue_id = rss_queue_for_packet(packet);
+
+    if (ring_mp_enqueue(&rx_rings[queue_id], packet) < 0) {
+        g_stack_stats.rx_queue_full++;
+        g_stack_stats.dropped_packets++;
+        free_packet_buffer(packet);
+        return -1;
+    }
+    return 0;
+}
+
+// Per-core worker loop body: drain up to `burst` packets from one RX
+// ring. Each worker polls exactly one queue_id, so every connection is
+// processed by the core its flow hashes to.
+int tcp_stack_rx_poll(uint32_t queue_id, uint32_t burst) {
+    if (queue_id >= num_rx_queues) {
+        return -1;
+    }
+
+    int processed = 0;
+    while ((uint32_t)processed < burst) {
+        packet_buffer_t *packet = ring_mc_dequeue(&rx_rings[queue_id]);
+        if (!packet) {
+            break;
+        }
+        process_packet(packet);
+        processed++;
+    }
+    return processed;
+}
+
+uint32_t tcp_stack_num_rx_queues(void) {
+    return num_rx_queues;
+}
+
 // High-performance packet transmission
 int transmit_packet(packet_buffer_t *packet) {
-    // Add to TX queue
-    uint32_t head = tx_queue.head;
-    uint32_t next_head = (head + 1) & tx_queue.mask;
-    
-    if (next_head == tx_queue.tail) {
+    // Lazily initialize this core's TX ring
+    if (!tx_queue.cells && ring_buffer_init(&tx_queue, RING_DEFAULT_SIZE) < 0) {
+        return -1;
+    }
+
+    if (ring_mp_enqueue(&tx_queue, packet) < 0) {
         // Queue full
         g_stack_stats.tx_queue_full++;
         return -1;
     }
-    
-    tx_queue.packets[head] = *packet;
-    __atomic_store_n(&tx_queue.head, next_head, __ATOMIC_RELEASE);
-    
+
     g_stack_stats.tx_packets++;
     return 0;
 }
 
+// Batched zero-copy TX with segmentation offload
+//
+// tcp_stack_sendv() accepts an iovec of application buffers and builds
+// TX descriptor chains that point straight at that memory — no payload
+// copy. One header template is built per call; with hardware TSO the
+// whole chain goes out as a single super-frame, otherwise it is split
+// in software at MSS boundaries, cloning and fixing up the template
+// (seq, length, PSH on the tail) per segment. A 64KB send is one call
+// and one template instead of ~44 copied packets.
+
+#define TCP_DEFAULT_MSS   1460
+#define TX_DESC_POOL_SIZE 1024
+#define TX_DESC_MAX_FRAGS 4
+#define TX_HEADER_LEN     (ETH_HLEN + sizeof(struct iphdr) + sizeof(struct tcphdr))
+
+// Marks a descriptor the NIC should segment itself. High bit so it
+// stays clear of the RX checksum flags when copied onto packet->flags.
+#define PKT_FLAG_TSO 0x80000000u
+
+// TSO is a NIC capability, not per-connection state: the driver
+// announces it once at init
+static int tx_hw_tso;
+
+void tcp_stack_set_hw_tso(int enabled) {
+    tx_hw_tso = enabled;
+}
+
+// Link-layer addresses for outgoing frames, set by the driver at init
+// (this stack has no ARP-resolved neighbour table; dst is the gateway)
+static uint8_t tx_src_mac[ETH_ALEN];
+static uint8_t tx_dst_mac[ETH_ALEN];
+
+void tcp_stack_set_link_addrs(const uint8_t *src_mac, const uint8_t *dst_mac) {
+    memcpy(tx_src_mac, src_mac, ETH_ALEN);
+    memcpy(tx_dst_mac, dst_mac, ETH_ALEN);
+}
+
+static void fill_eth_header(tcp_connection_t *conn, struct ethhdr *eth_hdr) {
+    (void)conn;
+    memcpy(eth_hdr->h_dest, tx_dst_mac, ETH_ALEN);
+    memcpy(eth_hdr->h_source, tx_src_mac, ETH_ALEN);
+    eth_hdr->h_proto = htons(ETH_P_IP);
+}
+
+typedef struct {
+    const void *addr;    // application memory, borrowed until completion
+    uint32_t len;
+} tx_frag_t;
+
+typedef struct tx_desc {
+    uint8_t header[TX_HEADER_LEN];
+    uint32_t header_len;
+    tx_frag_t frags[TX_DESC_MAX_FRAGS];
+    uint32_t num_frags;
+    uint32_t payload_len;
+    uint32_t flags;
+    struct tx_desc *next;
+} tx_desc_t;
+
+static tx_desc_t tx_desc_pool[TX_DESC_POOL_SIZE];
+static tx_desc_t *tx_desc_free_list;
+static int tx_desc_pool_seeded;
+static pthread_mutex_t tx_desc_seed_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static tx_desc_t *alloc_tx_desc(void) {
+    if (!tx_desc_pool_seeded) {
+        pthread_mutex_lock(&tx_desc_seed_lock);
+        if (!tx_desc_pool_seeded) {
+            for (int i = 0; i < TX_DESC_POOL_SIZE - 1; i++) {
+                tx_desc_pool[i].next = &tx_desc_pool[i + 1];
+            }
+            tx_desc_free_list = &tx_desc_pool[0];
+            tx_desc_pool_seeded = 1;
+        }
+        pthread_mutex_unlock(&tx_desc_seed_lock);
+    }
+
+    tx_desc_t *desc = tx_desc_free_list;
+    while (desc &&
+           !__atomic_compare_exchange_n(&tx_desc_free_list, &desc, desc->next,
+                                        true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    }
+    if (desc) {
+        desc->num_frags = 0;
+        desc->payload_len = 0;
+        desc->flags = 0;
+        desc->next = NULL;
+    }
+    return desc;
+}
+
+static void free_tx_desc_chain(tx_desc_t *chain) {
+    while (chain) {
+        tx_desc_t *next = chain->next;
+        tx_desc_t *head = tx_desc_free_list;
+        do {
+            chain->next = head;
+        } while (!__atomic_compare_exchange_n(&tx_desc_free_list, &head, chain,
+                                              true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+        chain = next;
+    }
+}
+
+// Build the shared header template for one sendv call. Checksums are
+// left to the NIC (TX csum offload); lengths and seq are fixed up per
+// segment.
+static void build_tx_header_template(tcp_connection_t *conn, uint8_t *header) {
+    fill_eth_header(conn, (struct ethhdr *)header);
+
+    struct iphdr *ip_hdr = (struct iphdr *)(header + ETH_HLEN);
+    ip_hdr->version = 4;
+    ip_hdr->ihl = 5;
+    ip_hdr->tos = 0;
+    ip_hdr->id = 0;
+    ip_hdr->frag_off = htons(0x4000);  // DF
+    ip_hdr->ttl = 64;
+    ip_hdr->protocol = IPPROTO_TCP;
+    ip_hdr->check = 0;
+    ip_hdr->saddr = htonl(conn->src_ip);
+    ip_hdr->daddr = htonl(conn->dst_ip);
+
+    struct tcphdr *tcp_hdr = (struct tcphdr *)(header + ETH_HLEN + sizeof(struct iphdr));
+    memset(tcp_hdr, 0, sizeof(struct tcphdr));
+    tcp_hdr->source = htons(conn->src_port);
+    tcp_hdr->dest = htons(conn->dst_port);
+    tcp_hdr->ack_seq = htonl(conn->rcv_nxt);
+    tcp_hdr->doff = sizeof(struct tcphdr) / 4;
+    tcp_hdr->ack = 1;
+    tcp_hdr->window = htons(65535);
+}
+
+// Fix the per-segment fields in a cloned template
+static void finalize_tx_segment(tx_desc_t *desc, uint32_t seq, int is_last) {
+    struct iphdr *ip_hdr = (struct iphdr *)(desc->header + ETH_HLEN);
+    ip_hdr->tot_len = htons(sizeof(struct iphdr) + sizeof(struct tcphdr) +
+                            desc->payload_len);
+
+    struct tcphdr *tcp_hdr =
+        (struct tcphdr *)(desc->header + ETH_HLEN + sizeof(struct iphdr));
+    tcp_hdr->seq = htonl(seq);
+    tcp_hdr->psh = is_last ? 1 : 0;
+}
+
+// Hand a descriptor chain to the TX path. A driver with hardware TSO
+// and scatter-gather would consume the descriptors directly; this
+// software path gathers each segment's frags into a pool buffer behind
+// its header and queues it on the per-core TX ring like any other
+// frame. Returns the number of segments queued; descriptors go back to
+// the pool either way.
+static int transmit_desc_chain(tx_desc_t *chain) {
+    int queued = 0;
+
+    for (tx_desc_t *desc = chain; desc; desc = desc->next) {
+        packet_buffer_t *packet = alloc_packet_buffer();
+        if (!packet) {
+            g_stack_stats.dropped_packets++;
+            continue;
+        }
+
+        uint8_t *dst = packet->data;
+        memcpy(dst, desc->header, desc->header_len);
+        dst += desc->header_len;
+        for (uint32_t f = 0; f < desc->num_frags; f++) {
+            memcpy(dst, desc->frags[f].addr, desc->frags[f].len);
+            dst += desc->frags[f].len;
+        }
+        packet->length = desc->header_len + desc->payload_len;
+        packet->flags = desc->flags;
+
+        if (transmit_packet(packet) < 0) {
+            g_stack_stats.dropped_packets++;
+            free_packet_buffer(packet);
+            continue;
+        }
+        queued++;
+    }
+
+    free_tx_desc_chain(chain);
+    return queued;
+}
+
+// Batched zero-copy send. Returns the number of segments queued, or -1.
+// The iovec memory must stay valid until TX completion.
+int tcp_stack_sendv(tcp_connection_t *conn, const struct iovec *iov, int iovcnt) {
+    if (!conn || conn->state != TCP_STATE_ESTABLISHED || iovcnt <= 0) {
+        return -1;
+    }
+
+    uint32_t mss = conn->mss ? conn->mss : TCP_DEFAULT_MSS;
+    uint32_t seg_max = tx_hw_tso ? 0xFFFF - TX_HEADER_LEN : mss;
+
+    uint8_t template[TX_HEADER_LEN];
+    build_tx_header_template(conn, template);
+
+    tx_desc_t *chain = NULL;
+    tx_desc_t **chain_tail = &chain;
+    tx_desc_t *desc = NULL;
+    int segments = 0;
+    uint32_t seq = conn->snd_nxt;
+
+    // Walk the iovec, carving MSS-sized (or TSO-sized) segments that
+    // reference caller memory directly
+    for (int i = 0; i < iovcnt; i++) {
+        const uint8_t *base = iov[i].iov_base;
+        size_t remaining = iov[i].iov_len;
+
+        while (remaining > 0) {
+            if (!desc) {
+                desc = alloc_tx_desc();
+                if (!desc) {
+                    free_tx_desc_chain(chain);
+                    return -1;
+                }
+                memcpy(desc->header, template, TX_HEADER_LEN);
+                desc->header_len = TX_HEADER_LEN;
+                if (tx_hw_tso) {
+                    desc->flags |= PKT_FLAG_TSO;
+                }
+            }
+
+            uint32_t take = seg_max - desc->payload_len;
+            if ((size_t)take > remaining) {
+                take = remaining;
+            }
+
+            desc->frags[desc->num_frags].addr = base;
+            desc->frags[desc->num_frags].len = take;
+            desc->num_frags++;
+            desc->payload_len += take;
+            base += take;
+            remaining -= take;
+
+            // Segment boundary: full, or out of frag slots
+            if (desc->payload_len == seg_max ||
+                desc->num_frags == TX_DESC_MAX_FRAGS) {
+                finalize_tx_segment(desc, seq,
+                                    remaining == 0 && i == iovcnt - 1);
+                seq += desc->payload_len;
+                *chain_tail = desc;
+                chain_tail = &desc->next;
+                segments++;
+                desc = NULL;
+            }
+        }
+    }
+
+    if (desc) {
+        finalize_tx_segment(desc, seq, 1);
+        seq += desc->payload_len;
+        *chain_tail = desc;
+        segments++;
+    }
+
+    uint32_t sent_bytes = seq - conn->snd_nxt;
+    conn->snd_nxt = seq;
+
+    // Hand the whole chain to the NIC in one shot. transmit_packet
+    // counts tx_packets per frame, so only bytes are accounted here.
+    segments = transmit_desc_chain(chain);
+    g_stack_stats.total_bytes += sent_bytes;
+
+    return segments;
+}
+
 // Congestion control - Cubic algorithm
 static void tcp_cubic_update(tcp_connection_t *conn) {
     uint64_t current_time = get_monotonic_time_us();
@@ -432,7 +972,8 @@ void tcp_stack_cleanup(void) {
         munmap(packet_pool, pool_size * sizeof(packet_buffer_t));
     }
     
-    for (int i = 0; i < TCP_HASH_SIZE; i++) {
-        pthread_rwlock_destroy(&tcp_hash_locks[i]);
+    for (uint32_t q = 0; q < num_rx_queues; q++) {
+        free(rx_rings[q].cells);
+        rx_rings[q].cells = NULL;
     }
-} 
\ No newline at end of file
+}
\ No newline at end of file
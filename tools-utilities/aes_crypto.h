@@ -39,6 +39,7 @@ typedef struct {
     uint64_t total_bytes;
     double last_encrypt_time;
     double last_decrypt_time;
+    double last_throughput_mbps;   // of the most recent bulk operation
     time_t init_time;
     time_t uptime;
 } aes_stats_t;
@@ -70,6 +71,13 @@ int aes_encrypt_cbc(aes_context_t *ctx, const uint8_t *plaintext,
                     size_t length, const uint8_t *iv, uint8_t *ciphertext);
 int aes_decrypt_cbc(aes_context_t *ctx, const uint8_t *ciphertext,
                     size_t length, const uint8_t *iv, uint8_t *plaintext);
+// CTR mode: counter blocks are independent, so the AES-NI path keeps 8
+// blocks in flight to fill the AESENC pipeline. Works on any length
+// (no padding); decryption is the same operation.
+int aes_encrypt_ctr(aes_context_t *ctx, const uint8_t *input,
+                    size_t length, const uint8_t *iv, uint8_t *output);
+int aes_decrypt_ctr(aes_context_t *ctx, const uint8_t *input,
+                    size_t length, const uint8_t *iv, uint8_t *output);
 
 // Statistics and utilities
 void aes_get_stats(const aes_context_t *ctx, aes_stats_t *stats);
@@ -1,7 +1,12 @@
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
 // Export functions for WebAssembly
 #define WASM_EXPORT __attribute__((visibility("default")))
 
@@ -53,9 +58,20 @@ static void swap(int32_t* a, int32_t* b) {
     *b = temp;
 }
 
+WASM_EXPORT int32_t introsort(int32_t* arr, int32_t size);
+
+// Recursion limit: already-sorted input drives quicksort_internal to
+// depth == size, which overflows the wasm stack long before 1M elements
+#define QUICKSORT_RECURSION_SAFE 4096
+
 WASM_EXPORT
 int32_t quicksort(int32_t* arr, int32_t size) {
     int32_t comparisons = 0;
+
+    if (size > QUICKSORT_RECURSION_SAFE) {
+        return introsort(arr, size);
+    }
+
     quicksort_internal(arr, 0, size - 1, &comparisons);
     return comparisons;
 }
@@ -160,6 +176,277 @@ int32_t heapsort(int32_t* arr, int32_t size) {
     return comparisons;
 }
 
+// ==================== SIMD128 + Introsort ====================
+//
+// The wasm build compiles the v128 paths in when -msimd128 is set;
+// JavaScript probes support with WebAssembly.validate and loads the
+// matching module. The flag below lets the demo A/B both paths at
+// runtime on a SIMD build.
+
+static int32_t simd_enabled = -1;  // -1: not probed yet
+
+WASM_EXPORT
+int32_t simd128_available() {
+#ifdef __wasm_simd128__
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+WASM_EXPORT
+void set_simd_enabled(int32_t enable) {
+    simd_enabled = enable && simd128_available();
+}
+
+#ifdef __wasm_simd128__
+static int32_t use_simd() {
+    if (simd_enabled < 0) {
+        simd_enabled = simd128_available();
+    }
+    return simd_enabled;
+}
+#endif
+
+// Vectorized min/max pass: 4 lanes per iteration
+WASM_EXPORT
+void array_minmax(int32_t* arr, int32_t size, int32_t* out_min, int32_t* out_max) {
+    if (size <= 0) return;
+
+    int32_t min_val = arr[0];
+    int32_t max_val = arr[0];
+    int32_t i = 0;
+
+#ifdef __wasm_simd128__
+    if (use_simd() && size >= 8) {
+        v128_t vmin = wasm_v128_load(&arr[0]);
+        v128_t vmax = vmin;
+        for (i = 4; i + 4 <= size; i += 4) {
+            v128_t v = wasm_v128_load(&arr[i]);
+            vmin = wasm_i32x4_min(vmin, v);
+            vmax = wasm_i32x4_max(vmax, v);
+        }
+        for (int32_t lane = 0; lane < 4; lane++) {
+            int32_t lo = wasm_i32x4_extract_lane(vmin, 0);
+            int32_t hi = wasm_i32x4_extract_lane(vmax, 0);
+            if (lo < min_val) min_val = lo;
+            if (hi > max_val) max_val = hi;
+            vmin = wasm_i32x4_shuffle(vmin, vmin, 1, 2, 3, 0);
+            vmax = wasm_i32x4_shuffle(vmax, vmax, 1, 2, 3, 0);
+        }
+    }
+#endif
+
+    for (; i < size; i++) {
+        if (arr[i] < min_val) min_val = arr[i];
+        if (arr[i] > max_val) max_val = arr[i];
+    }
+
+    *out_min = min_val;
+    *out_max = max_val;
+}
+
+#ifdef __wasm_simd128__
+
+// Scratch for the out-of-place vectorized partition
+static int32_t* sort_scratch = NULL;
+static int32_t sort_scratch_size = 0;
+
+// Swizzle table: for each 4-bit lane mask, byte indices that compact
+// the selected lanes to the front of the vector
+static uint8_t compact_table[16][16];
+static int32_t compact_table_ready = 0;
+
+static void build_compact_table() {
+    for (int32_t mask = 0; mask < 16; mask++) {
+        int32_t k = 0;
+        for (int32_t lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+                for (int32_t b = 0; b < 4; b++) {
+                    compact_table[mask][4 * k + b] = (uint8_t)(4 * lane + b);
+                }
+                k++;
+            }
+        }
+        for (; k < 4; k++) {
+            for (int32_t b = 0; b < 4; b++) {
+                compact_table[mask][4 * k + b] = 0;
+            }
+        }
+    }
+    compact_table_ready = 1;
+}
+
+// Vectorized partition: compare 4 lanes against the pivot, compact the
+// low/high lanes with a table-driven swizzle, then copy back around
+// the pivot. One pass, no branches in the hot loop.
+static int32_t simd_partition(int32_t* arr, int32_t low, int32_t high, int32_t* comparisons) {
+    int32_t pivot = arr[high];
+    int32_t* left = sort_scratch;
+    int32_t* right = sort_scratch + (sort_scratch_size / 2);
+    int32_t num_left = 0, num_right = 0;
+    int32_t i = low;
+
+    if (!compact_table_ready) {
+        build_compact_table();
+    }
+
+    v128_t pv = wasm_i32x4_splat(pivot);
+
+    for (; i + 4 <= high; i += 4) {
+        v128_t v = wasm_v128_load(&arr[i]);
+        int32_t mask = wasm_i32x4_bitmask(wasm_i32x4_le(v, pv));
+        int32_t below = __builtin_popcount(mask);
+
+        wasm_v128_store(&left[num_left],
+                        wasm_i8x16_swizzle(v, wasm_v128_load(compact_table[mask])));
+        wasm_v128_store(&right[num_right],
+                        wasm_i8x16_swizzle(v, wasm_v128_load(compact_table[15 ^ mask])));
+
+        num_left += below;
+        num_right += 4 - below;
+    }
+
+    for (; i < high; i++) {
+        if (arr[i] <= pivot) {
+            left[num_left++] = arr[i];
+        } else {
+            right[num_right++] = arr[i];
+        }
+    }
+
+    *comparisons += high - low;
+
+    memcpy(&arr[low], left, num_left * sizeof(int32_t));
+    arr[low + num_left] = pivot;
+    memcpy(&arr[low + num_left + 1], right, num_right * sizeof(int32_t));
+
+    return low + num_left;
+}
+
+#endif // __wasm_simd128__
+
+// Iterative introsort: explicit work stack instead of recursion, a
+// depth limit that degrades to heapsort on adversarial input, and
+// insertion sort for small partitions
+#define INTROSORT_SMALL 16
+
+static void insertion_sort_range(int32_t* arr, int32_t low, int32_t high, int32_t* comparisons) {
+    for (int32_t i = low + 1; i <= high; i++) {
+        int32_t key = arr[i];
+        int32_t j = i - 1;
+        while (j >= low) {
+            (*comparisons)++;
+            if (arr[j] <= key) break;
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+static void heapsort_range(int32_t* arr, int32_t low, int32_t high, int32_t* comparisons) {
+    int32_t* base = arr + low;
+    int32_t n = high - low + 1;
+
+    for (int32_t i = n / 2 - 1; i >= 0; i--)
+        heapify(base, n, i, comparisons);
+    for (int32_t i = n - 1; i > 0; i--) {
+        swap(&base[0], &base[i]);
+        heapify(base, i, 0, comparisons);
+    }
+}
+
+// Order low/mid/high and leave the median at arr[high] as the pivot
+static void median_of_three(int32_t* arr, int32_t low, int32_t high, int32_t* comparisons) {
+    int32_t mid = low + (high - low) / 2;
+
+    *comparisons += 3;
+    if (arr[mid] < arr[low]) swap(&arr[mid], &arr[low]);
+    if (arr[high] < arr[low]) swap(&arr[high], &arr[low]);
+    if (arr[high] < arr[mid]) swap(&arr[high], &arr[mid]);
+    swap(&arr[mid], &arr[high]);
+}
+
+static int32_t partition_range(int32_t* arr, int32_t low, int32_t high, int32_t* comparisons) {
+#ifdef __wasm_simd128__
+    if (use_simd() && sort_scratch && high - low >= 16) {
+        return simd_partition(arr, low, high, comparisons);
+    }
+#endif
+    return partition(arr, low, high, comparisons);
+}
+
+WASM_EXPORT
+int32_t introsort(int32_t* arr, int32_t size) {
+    int32_t comparisons = 0;
+
+    if (size < 2) return 0;
+
+#ifdef __wasm_simd128__
+    // The vectorized partition compacts into scratch; without it the
+    // sort silently stays scalar
+    if (use_simd() && sort_scratch_size < 2 * (size + 4)) {
+        free(sort_scratch);
+        sort_scratch_size = 2 * (size + 4);
+        sort_scratch = (int32_t*)malloc(sort_scratch_size * sizeof(int32_t));
+        if (!sort_scratch) sort_scratch_size = 0;
+    }
+#endif
+
+    // 2*log2(n) levels before degrading to heapsort
+    int32_t depth_limit = 0;
+    for (int32_t n = size; n > 1; n >>= 1) depth_limit += 2;
+
+    struct { int32_t low, high, depth; } stack[96];
+    int32_t top = 0;
+
+    stack[top].low = 0;
+    stack[top].high = size - 1;
+    stack[top].depth = depth_limit;
+    top++;
+
+    while (top > 0) {
+        top--;
+        int32_t low = stack[top].low;
+        int32_t high = stack[top].high;
+        int32_t depth = stack[top].depth;
+
+        while (high - low > INTROSORT_SMALL) {
+            if (depth-- == 0) {
+                heapsort_range(arr, low, high, &comparisons);
+                low = high;
+                break;
+            }
+
+            median_of_three(arr, low, high, &comparisons);
+            int32_t pivot = partition_range(arr, low, high, &comparisons);
+
+            // Iterate into the smaller half, stack the larger: the
+            // explicit stack stays O(log n) deep
+            if (pivot - low > high - pivot) {
+                stack[top].low = low;
+                stack[top].high = pivot - 1;
+                stack[top].depth = depth;
+                top++;
+                low = pivot + 1;
+            } else {
+                stack[top].low = pivot + 1;
+                stack[top].high = high;
+                stack[top].depth = depth;
+                top++;
+                high = pivot - 1;
+            }
+        }
+
+        if (high > low) {
+            insertion_sort_range(arr, low, high, &comparisons);
+        }
+    }
+
+    return comparisons;
+}
+
 // Sieve of Eratosthenes
 WASM_EXPORT
 int32_t sieve_of_eratosthenes(int32_t limit) {
@@ -171,25 +458,61 @@ int32_t sieve_of_eratosthenes(int32_t limit) {
     }
     
     // Initialize array (using as boolean array)
-    for (int32_t i = 0; i < limit; i++) {
-        shared_memory[i] = 1; // True
+    int32_t init = 0;
+#ifdef __wasm_simd128__
+    if (use_simd()) {
+        v128_t ones = wasm_i32x4_splat(1);
+        for (; init + 4 <= limit; init += 4) {
+            wasm_v128_store(&shared_memory[init], ones);
+        }
+    }
+#endif
+    for (; init < limit; init++) {
+        shared_memory[init] = 1; // True
     }
     shared_memory[0] = shared_memory[1] = 0; // 0 and 1 are not prime
-    
+
     for (int32_t p = 2; p * p < limit; p++) {
         if (shared_memory[p]) {
-            for (int32_t i = p * p; i < limit; i += p) {
+            int32_t i = p * p;
+#ifdef __wasm_simd128__
+            // v128 has no scatter store for stride-p marking, so mark
+            // four multiples per iteration to cut loop overhead instead
+            if (use_simd()) {
+                for (; i + 3 * p < limit; i += 4 * p) {
+                    shared_memory[i] = 0;
+                    shared_memory[i + p] = 0;
+                    shared_memory[i + 2 * p] = 0;
+                    shared_memory[i + 3 * p] = 0;
+                }
+            }
+#endif
+            for (; i < limit; i += p) {
                 shared_memory[i] = 0; // Mark as not prime
             }
         }
     }
-    
-    // Count primes
+
+    // Count primes: flags are 0/1, so counting is a vector add
     int32_t count = 0;
-    for (int32_t i = 2; i < limit; i++) {
+    int32_t i = 2;
+#ifdef __wasm_simd128__
+    if (use_simd()) {
+        v128_t acc = wasm_i32x4_splat(0);
+        for (i = 4; i + 4 <= limit; i += 4) {
+            acc = wasm_i32x4_add(acc, wasm_v128_load(&shared_memory[i]));
+        }
+        count = wasm_i32x4_extract_lane(acc, 0) +
+                wasm_i32x4_extract_lane(acc, 1) +
+                wasm_i32x4_extract_lane(acc, 2) +
+                wasm_i32x4_extract_lane(acc, 3);
+        count += shared_memory[2] + shared_memory[3];
+    }
+#endif
+    for (; i < limit; i++) {
         if (shared_memory[i]) count++;
     }
-    
+
     return count;
 }
 
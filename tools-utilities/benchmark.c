@@ -10,6 +10,9 @@
 #include <time.h>
 #include <unistd.h>
 #include <sys/time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 #include <pthread.h>
 #include "aes_crypto.h"
 
@@ -19,6 +22,12 @@
 #define NUM_THREADS            4
 #define WARMUP_ITERATIONS      1000
 
+// Sweep harness defaults (override with --threads/--sizes/--bytes)
+#define SWEEP_DEFAULT_THREADS   "1,2,4,8"
+#define SWEEP_DEFAULT_SIZES     "4096,65536,1048576"
+#define SWEEP_DEFAULT_BYTES     (256UL * 1024 * 1024)  // per measurement point
+#define SWEEP_MAX_LIST          16
+
 // Benchmark results structure
 typedef struct {
     double encryptions_per_second;
@@ -46,6 +55,72 @@ static double get_time(void) {
     return tv.tv_sec + tv.tv_usec / 1000000.0;
 }
 
+// Cycle counter
+static inline uint64_t rdtsc(void) {
+    uint32_t hi, lo;
+    __asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// perf_event_open counters: cycles and last-level cache misses. Counters
+// are opened with inherit=1 so worker threads created inside the
+// measured region are included. Unavailable counters (restricted
+// perf_event_paranoid, VMs) read back as -1 and show as null in JSON.
+typedef struct {
+    int fd_cycles;
+    int fd_cache_misses;
+} perf_counters_t;
+
+static int perf_open_counter(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void perf_counters_start(perf_counters_t *pc) {
+    pc->fd_cycles = perf_open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    pc->fd_cache_misses = perf_open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    if (pc->fd_cycles >= 0) {
+        ioctl(pc->fd_cycles, PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fd_cycles, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    if (pc->fd_cache_misses >= 0) {
+        ioctl(pc->fd_cache_misses, PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fd_cache_misses, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+// Returns counts via out params; -1 means the counter was unavailable
+static void perf_counters_stop(perf_counters_t *pc, int64_t *cycles,
+                               int64_t *cache_misses) {
+    *cycles = -1;
+    *cache_misses = -1;
+
+    if (pc->fd_cycles >= 0) {
+        ioctl(pc->fd_cycles, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(pc->fd_cycles, cycles, sizeof(*cycles)) != sizeof(*cycles)) {
+            *cycles = -1;
+        }
+        close(pc->fd_cycles);
+    }
+    if (pc->fd_cache_misses >= 0) {
+        ioctl(pc->fd_cache_misses, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(pc->fd_cache_misses, cache_misses, sizeof(*cache_misses)) !=
+            sizeof(*cache_misses)) {
+            *cache_misses = -1;
+        }
+        close(pc->fd_cache_misses);
+    }
+}
+
 // Generate random data
 static void generate_random_data(uint8_t *data, size_t size) {
     srand(time(NULL));
@@ -294,6 +369,208 @@ static void verify_constant_time(void) {
     }
 }
 
+// Sweep harness
+//
+// Measures every (mode, buffer size, thread count) combination with
+// wall time, rdtsc, and perf_event_open cycle / cache-miss counters,
+// and emits machine-readable JSON so runs can be diffed across kernel
+// and microcode updates.
+
+typedef struct {
+    aes_mode_t mode;
+    uint8_t *input;
+    uint8_t *output;
+    size_t buffer_size;
+    size_t iterations;
+} sweep_thread_t;
+
+static void *sweep_worker(void *arg) {
+    sweep_thread_t *data = (sweep_thread_t *)arg;
+    aes_context_t ctx;
+    uint8_t key[AES_KEY_SIZE];
+    uint8_t iv[AES_BLOCK_SIZE];
+
+    generate_random_data(key, AES_KEY_SIZE);
+    generate_random_data(iv, AES_BLOCK_SIZE);
+    aes_init(&ctx, key, data->mode);
+
+    for (size_t i = 0; i < data->iterations; i++) {
+        switch (data->mode) {
+            case AES_MODE_ECB:
+                aes_encrypt_ecb(&ctx, data->input, data->buffer_size, data->output);
+                break;
+            case AES_MODE_CBC:
+                aes_encrypt_cbc(&ctx, data->input, data->buffer_size, iv, data->output);
+                break;
+            case AES_MODE_CTR:
+                aes_encrypt_ctr(&ctx, data->input, data->buffer_size, iv, data->output);
+                break;
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+static const char *mode_name(aes_mode_t mode) {
+    switch (mode) {
+        case AES_MODE_ECB: return "ecb";
+        case AES_MODE_CBC: return "cbc";
+        case AES_MODE_CTR: return "ctr";
+        default: return "unknown";
+    }
+}
+
+// One measurement point; appends a JSON record to `out`
+static void sweep_point(FILE *out, aes_mode_t mode, size_t buffer_size,
+                        int threads, size_t total_bytes, int *first) {
+    size_t iterations = total_bytes / buffer_size / threads;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    pthread_t tids[SWEEP_MAX_LIST];
+    sweep_thread_t data[SWEEP_MAX_LIST];
+
+    for (int t = 0; t < threads; t++) {
+        data[t].mode = mode;
+        data[t].buffer_size = buffer_size;
+        data[t].iterations = iterations;
+        data[t].input = malloc(buffer_size);
+        data[t].output = malloc(buffer_size);
+        if (!data[t].input || !data[t].output) {
+            fprintf(stderr, "sweep: allocation failed\n");
+            exit(1);
+        }
+        generate_random_data(data[t].input, buffer_size);
+    }
+
+    // Warmup: one pass on the calling thread
+    data[0].iterations = 1;
+    sweep_worker(&data[0]);
+    data[0].iterations = iterations;
+
+    perf_counters_t pc;
+    perf_counters_start(&pc);
+    uint64_t tsc_start = rdtsc();
+    double wall_start = get_time();
+
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&tids[t], NULL, sweep_worker, &data[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+
+    double seconds = get_time() - wall_start;
+    uint64_t tsc_cycles = rdtsc() - tsc_start;
+    int64_t cycles, cache_misses;
+    perf_counters_stop(&pc, &cycles, &cache_misses);
+
+    double bytes = (double)buffer_size * iterations * threads;
+    double mbps = bytes / seconds / (1024.0 * 1024.0);
+
+    fprintf(out, "%s\n    {\"mode\": \"%s\", \"buffer_size\": %zu, \"threads\": %d, "
+                 "\"iterations\": %zu, \"seconds\": %.6f, \"mb_per_s\": %.2f, "
+                 "\"tsc_cycles\": %llu",
+            *first ? "" : ",", mode_name(mode), buffer_size, threads,
+            iterations, seconds, mbps, (unsigned long long)tsc_cycles);
+    if (cycles >= 0) {
+        fprintf(out, ", \"cycles_per_byte\": %.3f", (double)cycles / bytes);
+    } else {
+        fprintf(out, ", \"cycles_per_byte\": null");
+    }
+    if (cache_misses >= 0) {
+        fprintf(out, ", \"cache_misses_per_kb\": %.3f",
+                (double)cache_misses / (bytes / 1024.0));
+    } else {
+        fprintf(out, ", \"cache_misses_per_kb\": null");
+    }
+    fprintf(out, "}");
+    *first = 0;
+
+    // Progress goes to stderr: stdout may be the JSON stream when no
+    // --json path was given, and interleaving would corrupt it
+    fprintf(stderr, "  %-3s  %8zu B  %2d thread%s  %9.2f MB/s\n",
+            mode_name(mode), buffer_size, threads, threads > 1 ? "s" : " ", mbps);
+
+    for (int t = 0; t < threads; t++) {
+        free(data[t].input);
+        free(data[t].output);
+    }
+}
+
+// Parse "1,2,4" into values[]; returns count
+static int parse_list(const char *arg, size_t *values, int max) {
+    int count = 0;
+    char *copy = strdup(arg);
+    for (char *tok = strtok(copy, ","); tok && count < max; tok = strtok(NULL, ",")) {
+        values[count++] = strtoul(tok, NULL, 10);
+    }
+    free(copy);
+    return count;
+}
+
+static int run_sweep(int argc, char *argv[]) {
+    const char *threads_arg = SWEEP_DEFAULT_THREADS;
+    const char *sizes_arg = SWEEP_DEFAULT_SIZES;
+    const char *json_path = NULL;
+    size_t total_bytes = SWEEP_DEFAULT_BYTES;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads_arg = argv[++i];
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizes_arg = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--bytes") == 0 && i + 1 < argc) {
+            total_bytes = strtoul(argv[++i], NULL, 10);
+        }
+    }
+
+    size_t thread_counts[SWEEP_MAX_LIST], sizes[SWEEP_MAX_LIST];
+    int num_threads = parse_list(threads_arg, thread_counts, SWEEP_MAX_LIST);
+    int num_sizes = parse_list(sizes_arg, sizes, SWEEP_MAX_LIST);
+    aes_mode_t modes[] = {AES_MODE_ECB, AES_MODE_CBC, AES_MODE_CTR};
+
+    FILE *out = json_path ? fopen(json_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "sweep: cannot open %s\n", json_path);
+        return 1;
+    }
+
+    aes_context_t probe;
+    uint8_t dummy_key[AES_KEY_SIZE] = {0};
+    aes_init(&probe, dummy_key, AES_MODE_ECB);
+
+    fprintf(stderr, "Sweep: %d modes x %d sizes x %d thread counts, %zu MB per point\n",
+            3, num_sizes, num_threads, total_bytes / (1024 * 1024));
+
+    fprintf(out, "{\n  \"aes_ni\": %s,\n  \"cpu_cores\": %ld,\n  \"results\": [",
+            probe.has_aes_ni ? "true" : "false", sysconf(_SC_NPROCESSORS_ONLN));
+
+    int first = 1;
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        for (int s = 0; s < num_sizes; s++) {
+            for (int t = 0; t < num_threads; t++) {
+                int threads = (int)thread_counts[t];
+                if (threads < 1 || threads > SWEEP_MAX_LIST) {
+                    continue;
+                }
+                sweep_point(out, modes[m], sizes[s], threads, total_bytes, &first);
+            }
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+        printf("JSON results written to %s\n", json_path);
+    }
+    return 0;
+}
+
 // Print detailed results
 static void print_results(const benchmark_results_t *results) {
     printf("\n=== Benchmark Results ===\n");
@@ -323,6 +600,9 @@ int main(int argc, char *argv[]) {
     
     // Check for command line arguments
     int run_extended = 0;
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        return run_sweep(argc, argv);
+    }
     if (argc > 1 && strcmp(argv[1], "--extended") == 0) {
         run_extended = 1;
         printf("Running extended benchmark suite...\n\n");
@@ -24,6 +24,7 @@
 #include <netdb.h>
 #include <fcntl.h>
 #include <sys/select.h>
+#include <sys/epoll.h>
 #include <ifaddrs.h>
 #include <net/if.h>
 #include <pcap.h>
@@ -83,6 +84,8 @@ void print_usage(const char *program_name) {
     printf("  -f, --format        Output format: human, json, xml, csv\n");
     printf("  -r, --rate RATE     Rate limit packets/sec (default: 100)\n");
     printf("  -S, --stealth       Enable stealth mode\n");
+    printf("  -L, --stateless     Stateless SYN mode (constant memory,\n");
+    printf("                      SipHash cookies validate responses)\n");
     printf("  -n, --no-resolve    Don't resolve hostnames\n");
     printf("  -v, --verbose       Verbose output\n");
     printf("  -O, --os-detect     Enable OS detection\n");
@@ -337,6 +340,514 @@ scan_result_t udp_scan(const char *target_ip, uint16_t port) {
     return result;
 }
 
+// ============================================================
+// Async SYN engine
+//
+// The thread-pool path costs one blocked thread per probe. Here one
+// sender thread streams raw SYNs while one receiver thread sits on
+// epoll over the raw socket and classifies SYN/ACK vs RST. Sent probes
+// travel to the receiver over a lock-free SPSC ring; the receiver
+// keeps them in a hash table until the response (or timeout) arrives.
+// ============================================================
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// SPSC ring: sender produces, receiver consumes, no locks
+static int probe_ring_push(probe_ring_t *ring, const syn_probe_t *probe) {
+    uint32_t tail = ring->tail;
+    uint32_t next = (tail + 1) & (ASYNC_RING_SIZE - 1);
+
+    if (next == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+        return -1; // Full
+    }
+
+    ring->slots[tail] = *probe;
+    __atomic_store_n(&ring->tail, next, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int probe_ring_pop(probe_ring_t *ring, syn_probe_t *probe) {
+    uint32_t head = ring->head;
+
+    if (head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+        return -1; // Empty
+    }
+
+    *probe = ring->slots[head];
+    __atomic_store_n(&ring->head, (head + 1) & (ASYNC_RING_SIZE - 1),
+                     __ATOMIC_RELEASE);
+    return 0;
+}
+
+// Stateless mode: instead of remembering probes, we encode target
+// identity into the SYN sequence number with a keyed SipHash-2-4. A
+// response proves itself genuine by acknowledging cookie+1, so the
+// scanner keeps no per-probe state at all and memory stays constant
+// no matter how many probes are in flight.
+
+static uint64_t g_siphash_key[2];
+
+#define SIP_ROTL(x, b) ((uint64_t)(((x) << (b)) | ((x) >> (64 - (b)))))
+
+#define SIP_ROUND(v0, v1, v2, v3)                  \
+    do {                                           \
+        v0 += v1; v1 = SIP_ROTL(v1, 13); v1 ^= v0; \
+        v0 = SIP_ROTL(v0, 32);                     \
+        v2 += v3; v3 = SIP_ROTL(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = SIP_ROTL(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = SIP_ROTL(v1, 17); v1 ^= v2; \
+        v2 = SIP_ROTL(v2, 32);                     \
+    } while (0)
+
+// SipHash-2-4 over a single 8-byte message
+static uint64_t siphash24(uint64_t k0, uint64_t k1, uint64_t m) {
+    uint64_t v0 = k0 ^ 0x736F6D6570736575ULL;
+    uint64_t v1 = k1 ^ 0x646F72616E646F6DULL;
+    uint64_t v2 = k0 ^ 0x6C7967656E657261ULL;
+    uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+    uint64_t b = 8ULL << 56;
+
+    v3 ^= m;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    v0 ^= m;
+
+    v3 ^= b;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    v0 ^= b;
+
+    v2 ^= 0xFF;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+static void siphash_key_init(void) {
+    FILE *urandom = fopen("/dev/urandom", "r");
+    if (urandom) {
+        if (fread(g_siphash_key, sizeof(g_siphash_key), 1, urandom) != 1) {
+            g_siphash_key[0] = (uint64_t)time(NULL);
+        }
+        fclose(urandom);
+    } else {
+        g_siphash_key[0] = (uint64_t)time(NULL) ^ getpid();
+        g_siphash_key[1] = (uint64_t)clock();
+    }
+}
+
+// Cookie carried in the SYN sequence number
+static uint32_t syn_cookie(uint32_t daddr, uint16_t port) {
+    uint64_t m = ((uint64_t)daddr << 16) | port;
+    return (uint32_t)siphash24(g_siphash_key[0], g_siphash_key[1], m);
+}
+
+// Outstanding-probe table (open addressing, power-of-two size).
+// Answered probes become tombstones rather than empties: a probe chain
+// may pass through them, and ending the scan there would make every
+// colliding key unfindable after its neighbour is answered.
+#define PROBE_SLOT_EMPTY   0    // Never used (calloc state)
+#define PROBE_SLOT_PENDING 1    // Probe in flight
+#define PROBE_SLOT_DONE    2    // Answered; tombstone, reusable
+
+typedef struct {
+    uint32_t daddr;
+    uint16_t port;
+    uint8_t state;
+    double send_time;
+} pending_probe_t;
+
+typedef struct {
+    pending_probe_t *slots;
+    uint32_t mask;
+    uint32_t count;
+} pending_table_t;
+
+static uint32_t pending_hash(uint32_t daddr, uint16_t port) {
+    uint64_t h = ((uint64_t)daddr << 16) | port;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(h >> 32);
+}
+
+static pending_probe_t *pending_find_slot(pending_table_t *table,
+                                          uint32_t daddr, uint16_t port) {
+    uint32_t idx = pending_hash(daddr, port) & table->mask;
+    pending_probe_t *reuse = NULL;
+
+    for (uint32_t probes = 0; probes <= table->mask; probes++) {
+        pending_probe_t *slot = &table->slots[idx];
+        if (slot->state == PROBE_SLOT_EMPTY) {
+            // End of the chain: hand back the first tombstone passed,
+            // if any, so reinsertions don't grow the chains
+            return reuse ? reuse : slot;
+        }
+        if (slot->daddr == daddr && slot->port == port) {
+            return slot;
+        }
+        if (slot->state == PROBE_SLOT_DONE && !reuse) {
+            reuse = slot;
+        }
+        idx = (idx + 1) & table->mask;
+    }
+    return reuse; // NULL only when the table is truly full
+}
+
+// Shared state between sender and receiver
+typedef struct {
+    char **targets;
+    int target_count;
+    uint16_t *ports;
+    int port_count;
+
+    int send_sock;
+    int recv_sock;
+    uint32_t saddr;                // Our source address
+    probe_ring_t ring;
+    volatile int sender_done;
+    volatile int stop;
+} async_scan_t;
+
+// TCP checksum over the pseudo-header + segment
+static uint16_t tcp_checksum(struct iphdr *ip, struct tcphdr *tcp) {
+    struct {
+        uint32_t saddr;
+        uint32_t daddr;
+        uint8_t zero;
+        uint8_t protocol;
+        uint16_t tcp_len;
+    } __attribute__((packed)) pseudo = {
+        .saddr = ip->saddr,
+        .daddr = ip->daddr,
+        .zero = 0,
+        .protocol = IPPROTO_TCP,
+        .tcp_len = htons(sizeof(struct tcphdr))
+    };
+
+    char buf[sizeof(pseudo) + sizeof(struct tcphdr)];
+    memcpy(buf, &pseudo, sizeof(pseudo));
+    memcpy(buf + sizeof(pseudo), tcp, sizeof(struct tcphdr));
+
+    return calculate_checksum((uint16_t *)buf, sizeof(buf));
+}
+
+// Find the source address the kernel would use for this destination
+static uint32_t local_source_addr(uint32_t daddr) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        return 0;
+    }
+
+    struct sockaddr_in dest = {
+        .sin_family = AF_INET,
+        .sin_port = htons(53),
+        .sin_addr.s_addr = daddr
+    };
+
+    uint32_t saddr = 0;
+    if (connect(sock, (struct sockaddr *)&dest, sizeof(dest)) == 0) {
+        struct sockaddr_in local;
+        socklen_t len = sizeof(local);
+        if (getsockname(sock, (struct sockaddr *)&local, &len) == 0) {
+            saddr = local.sin_addr.s_addr;
+        }
+    }
+
+    close(sock);
+    return saddr;
+}
+
+// Sender thread: stream SYNs as fast as the rate limit allows
+static void *async_sender_thread(void *arg) {
+    async_scan_t *scan = (async_scan_t *)arg;
+    char packet[sizeof(struct iphdr) + sizeof(struct tcphdr)];
+    int sent_in_burst = 0;
+
+    for (int t = 0; t < scan->target_count && g_running; t++) {
+        struct in_addr target;
+        if (inet_pton(AF_INET, scan->targets[t], &target) != 1) {
+            continue;
+        }
+
+        for (int p = 0; p < scan->port_count && g_running; p++) {
+            uint16_t port = scan->ports[p];
+
+            memset(packet, 0, sizeof(packet));
+            struct iphdr *ip = (struct iphdr *)packet;
+            struct tcphdr *tcp = (struct tcphdr *)(packet + sizeof(struct iphdr));
+
+            ip->ihl = 5;
+            ip->version = 4;
+            ip->tot_len = htons(sizeof(packet));
+            ip->id = htons(getpid() & 0xFFFF);
+            ip->ttl = 64;
+            ip->protocol = IPPROTO_TCP;
+            ip->saddr = scan->saddr;
+            ip->daddr = target.s_addr;
+
+            tcp->source = htons(ASYNC_SRC_PORT);
+            tcp->dest = htons(port);
+            if (g_config.stateless) {
+                // The response validates itself by acking cookie+1
+                tcp->seq = htonl(syn_cookie(target.s_addr, port));
+            } else {
+                tcp->seq = htonl(pending_hash(target.s_addr, port));
+            }
+            tcp->doff = 5;
+            tcp->syn = 1;
+            tcp->window = htons(14600);
+
+            ip->check = calculate_checksum((uint16_t *)ip, sizeof(struct iphdr));
+            tcp->check = tcp_checksum(ip, tcp);
+
+            struct sockaddr_in dest = {
+                .sin_family = AF_INET,
+                .sin_port = tcp->dest,
+                .sin_addr.s_addr = target.s_addr
+            };
+
+            if (sendto(scan->send_sock, packet, sizeof(packet), 0,
+                       (struct sockaddr *)&dest, sizeof(dest)) < 0) {
+                continue;
+            }
+
+            // Hand the probe to the receiver; spin briefly if it lags.
+            // Stateless mode keeps nothing: the cookie is the state.
+            if (!g_config.stateless) {
+                syn_probe_t probe = {
+                    .daddr = target.s_addr,
+                    .port = port,
+                    .send_time = monotonic_seconds()
+                };
+                while (probe_ring_push(&scan->ring, &probe) < 0 && g_running) {
+                    usleep(100);
+                }
+            }
+
+            // Rate limiting in bursts instead of per-packet sleeps
+            if (g_config.rate_limit > 0 &&
+                ++sent_in_burst >= ASYNC_SEND_BURST) {
+                usleep((useconds_t)(ASYNC_SEND_BURST * 1000000L /
+                                    g_config.rate_limit));
+                sent_in_burst = 0;
+            }
+        }
+    }
+
+    scan->sender_done = 1;
+    return NULL;
+}
+
+// Record a classified response and update the shared stats
+static void async_report(uint32_t daddr, uint16_t port, port_state_t state,
+                         double rtt) {
+    scan_result_t result = {0};
+    struct in_addr addr = { .s_addr = daddr };
+
+    inet_ntop(AF_INET, &addr, result.ip, sizeof(result.ip));
+    result.port = port;
+    result.protocol = IPPROTO_TCP;
+    result.state = state;
+    result.response_time = rtt;
+    detect_service(&result);
+
+    print_scan_result(&result);
+
+    pthread_mutex_lock(&g_stats.mutex);
+    g_stats.ports_scanned++;
+    if (state == PORT_OPEN) {
+        g_stats.ports_open++;
+    } else if (state == PORT_CLOSED) {
+        g_stats.ports_closed++;
+    } else {
+        g_stats.ports_filtered++;
+    }
+    pthread_mutex_unlock(&g_stats.mutex);
+}
+
+// Receiver thread: epoll on the raw socket, classify SYN/ACK vs RST
+static void *async_receiver_thread(void *arg) {
+    async_scan_t *scan = (async_scan_t *)arg;
+
+    // Pending table sized for twice the probe count; stateless mode
+    // tracks nothing, so it allocates nothing
+    pending_table_t table = {0};
+    if (!g_config.stateless) {
+        uint32_t capacity = 1024;
+        uint64_t total = (uint64_t)scan->target_count * scan->port_count;
+        while (capacity < total * 2 && capacity < (1u << 26)) {
+            capacity <<= 1;
+        }
+
+        table.slots = calloc(capacity, sizeof(pending_probe_t));
+        table.mask = capacity - 1;
+        if (!table.slots) {
+            return NULL;
+        }
+    }
+
+    int epfd = epoll_create1(0);
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = scan->recv_sock };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, scan->recv_sock, &ev);
+
+    char packet[4096];
+
+    while (!scan->stop && g_running) {
+        // Pull freshly sent probes into the table
+        syn_probe_t probe;
+        while (table.slots && probe_ring_pop(&scan->ring, &probe) == 0) {
+            pending_probe_t *slot =
+                pending_find_slot(&table, probe.daddr, probe.port);
+            if (slot && slot->state != PROBE_SLOT_PENDING) {
+                slot->daddr = probe.daddr;
+                slot->port = probe.port;
+                slot->send_time = probe.send_time;
+                slot->state = PROBE_SLOT_PENDING;
+                table.count++;
+            }
+        }
+
+        struct epoll_event events[8];
+        int n = epoll_wait(epfd, events, 8, 100);
+        if (n <= 0) {
+            continue;
+        }
+
+        // Drain everything the socket has
+        ssize_t len;
+        while ((len = recv(scan->recv_sock, packet, sizeof(packet),
+                           MSG_DONTWAIT)) > 0) {
+            if ((size_t)len < sizeof(struct iphdr) + sizeof(struct tcphdr)) {
+                continue;
+            }
+
+            struct iphdr *ip = (struct iphdr *)packet;
+            if (ip->protocol != IPPROTO_TCP) {
+                continue;
+            }
+
+            struct tcphdr *tcp =
+                (struct tcphdr *)(packet + ip->ihl * 4);
+
+            // Only responses to our probes
+            if (ntohs(tcp->dest) != ASYNC_SRC_PORT) {
+                continue;
+            }
+
+            uint16_t sport = ntohs(tcp->source);
+
+            if (g_config.stateless) {
+                // Self-validating response: it must ack our cookie+1
+                uint32_t expected = syn_cookie(ip->saddr, sport) + 1;
+                if (ntohl(tcp->ack_seq) != expected) {
+                    continue;
+                }
+
+                if (tcp->syn && tcp->ack) {
+                    async_report(ip->saddr, sport, PORT_OPEN, 0);
+                } else if (tcp->rst) {
+                    async_report(ip->saddr, sport, PORT_CLOSED, 0);
+                }
+                continue;
+            }
+
+            pending_probe_t *slot =
+                pending_find_slot(&table, ip->saddr, sport);
+            if (!slot || slot->state != PROBE_SLOT_PENDING) {
+                continue; // Unsolicited, or a duplicate of an answered probe
+            }
+
+            double rtt = monotonic_seconds() - slot->send_time;
+
+            if (tcp->syn && tcp->ack) {
+                async_report(ip->saddr, sport, PORT_OPEN, rtt);
+            } else if (tcp->rst) {
+                async_report(ip->saddr, sport, PORT_CLOSED, rtt);
+            } else {
+                continue;
+            }
+
+            slot->state = PROBE_SLOT_DONE;
+            table.count--;
+        }
+    }
+
+    // Everything still pending never answered: filtered. (Stateless
+    // mode cannot tell silence from loss, so it reports answers only.)
+    if (table.slots) {
+        for (uint32_t i = 0; i <= table.mask; i++) {
+            if (table.slots[i].state == PROBE_SLOT_PENDING) {
+                async_report(table.slots[i].daddr, table.slots[i].port,
+                             PORT_FILTERED, 0);
+            }
+        }
+        free(table.slots);
+    }
+
+    close(epfd);
+    return NULL;
+}
+
+// Drive a full async SYN scan; returns -1 if raw sockets are
+// unavailable so the caller can fall back to the thread pool
+int run_async_syn_scan(char **targets, int target_count,
+                       uint16_t *ports, int port_count) {
+    if (target_count <= 0 || port_count <= 0) {
+        return -1;
+    }
+
+    async_scan_t scan = {
+        .targets = targets,
+        .target_count = target_count,
+        .ports = ports,
+        .port_count = port_count
+    };
+
+    scan.send_sock = create_raw_socket();
+    if (scan.send_sock < 0) {
+        return -1; // No privileges; create_raw_socket already downgraded
+    }
+
+    scan.recv_sock = socket(AF_INET, SOCK_RAW, IPPROTO_TCP);
+    if (scan.recv_sock < 0) {
+        close(scan.send_sock);
+        return -1;
+    }
+
+    struct in_addr first;
+    inet_pton(AF_INET, targets[0], &first);
+    scan.saddr = local_source_addr(first.s_addr);
+
+    if (g_config.stateless) {
+        siphash_key_init();
+    }
+
+    printf("[+] Async SYN engine: %d targets x %d ports, rate %d pps%s\n",
+           target_count, port_count, g_config.rate_limit,
+           g_config.stateless ? ", stateless" : "");
+
+    pthread_t sender, receiver;
+    pthread_create(&receiver, NULL, async_receiver_thread, &scan);
+    pthread_create(&sender, NULL, async_sender_thread, &scan);
+
+    pthread_join(sender, NULL);
+
+    // Give stragglers one timeout window to answer
+    usleep(g_config.timeout_ms * 1000);
+    scan.stop = 1;
+    pthread_join(receiver, NULL);
+
+    close(scan.send_sock);
+    close(scan.recv_sock);
+    return 0;
+}
+
 // Service detection based on port and banner
 void detect_service(scan_result_t *result) {
     struct {
@@ -774,6 +1285,8 @@ int main(int argc, char *argv[]) {
             return 0;
         } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
             g_config.verbose = 1;
+        } else if (strcmp(argv[i], "-L") == 0 || strcmp(argv[i], "--stateless") == 0) {
+            g_config.stateless = 1;
         } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--ports") == 0) {
             if (++i < argc) port_spec = argv[i];
         } else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) {
@@ -842,6 +1355,23 @@ int main(int argc, char *argv[]) {
         printf("────────────────────────────────────────────────────────────────────────\n");
     }
     
+    // Fast path: asynchronous SYN engine (sender + epoll receiver).
+    // Falls back to the thread pool when raw sockets are unavailable.
+    if (g_config.scan_type == SCAN_TCP_SYN &&
+        run_async_syn_scan(targets, target_count, ports, port_count) == 0) {
+        g_stats.hosts_scanned = target_count;
+        print_statistics();
+
+        for (int i = 0; i < target_count; i++) {
+            free(targets[i]);
+        }
+        free(targets);
+        free(ports);
+
+        printf("\n[+] Scan completed\n");
+        return 0;
+    }
+
     // Initialize work queue
     work_queue_init(&g_work_queue);
     
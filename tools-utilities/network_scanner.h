@@ -61,6 +61,7 @@ typedef struct {
     int os_detection;
     int version_detection;
     int script_scan;
+    int stateless;      // SipHash-encoded probes, no per-probe state
 } scanner_config_t;
 
 // Scan result
@@ -77,6 +78,25 @@ typedef struct {
     double response_time;
 } scan_result_t;
 
+// Async SYN engine: one sender thread writes raw SYNs, one epoll
+// receiver matches responses; a lock-free single-producer ring hands
+// sent probes from sender to receiver for matching
+#define ASYNC_RING_SIZE     65536   // Power of two
+#define ASYNC_SRC_PORT      54321
+#define ASYNC_SEND_BURST    64
+
+typedef struct {
+    uint32_t daddr;                 // Network byte order
+    uint16_t port;
+    double send_time;
+} syn_probe_t;
+
+typedef struct {
+    syn_probe_t slots[ASYNC_RING_SIZE];
+    volatile uint32_t head __attribute__((aligned(64)));  // Consumer
+    volatile uint32_t tail __attribute__((aligned(64)));  // Producer
+} probe_ring_t;
+
 // Work item for thread pool
 typedef struct work_item {
     char target_ip[MAX_IP_LEN];
@@ -172,6 +192,10 @@ void work_queue_add(work_queue_t *queue, const char *target_ip, uint16_t port);
 work_item_t* work_queue_get(work_queue_t *queue);
 void work_queue_destroy(work_queue_t *queue);
 
+// Async SYN engine
+int run_async_syn_scan(char **targets, int target_count,
+                       uint16_t *ports, int port_count);
+
 // Thread management
 void* worker_thread(void *arg);
 int start_thread_pool(int thread_count);
@@ -21,6 +21,13 @@
 #include <libxml/tree.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <strings.h>
 
 #include "web_vulnerability_scanner.h"
 
@@ -369,6 +376,526 @@ int start_vulnerability_scan(scan_config_t *config, scan_result_t **results, int
     return 0;
 }
 
+// ==================== Keep-Alive Connection Pool ====================
+//
+// Opening a fresh blocking connection per probe means every payload
+// pays a full TCP handshake before a single byte of HTTP goes out,
+// and handshakes end up dominating scan wall time. The pool below
+// keeps POOL_CONNECTIONS non-blocking sockets open to the target and
+// pipelines up to POOL_PIPELINE_DEPTH HTTP/1.1 requests on each, so a
+// batch of hundreds of payloads reuses a handful of handshakes.
+
+// Split "http://host[:port]/path" into pool fields
+static int pool_parse_url(connection_pool_t *pool, const char *url) {
+    const char *p = url;
+
+    if (strncmp(p, "http://", 7) == 0) {
+        p += 7;
+    } else if (strncmp(p, "https://", 8) == 0) {
+        // TLS is left to the curl path; the pool handles plain HTTP
+        return -1;
+    } else {
+        return -1;
+    }
+
+    size_t host_len = strcspn(p, ":/");
+    if (host_len == 0 || host_len >= POOL_HOST_LENGTH) {
+        return -1;
+    }
+
+    memcpy(pool->host, p, host_len);
+    pool->host[host_len] = '\0';
+    p += host_len;
+
+    pool->port = 80;
+    if (*p == ':') {
+        pool->port = atoi(p + 1);
+        if (pool->port <= 0 || pool->port > 65535) {
+            return -1;
+        }
+        while (*p && *p != '/') p++;
+    }
+
+    snprintf(pool->base_path, sizeof(pool->base_path), "%s", *p ? p : "/");
+    return 0;
+}
+
+// Start a non-blocking connect; completion is detected via POLLOUT
+static int pool_open_socket(const char *host, int port) {
+    struct addrinfo hints = {0}, *res;
+    char port_str[8];
+
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port_str, sizeof(port_str), "%d", port);
+
+    if (getaddrinfo(host, port_str, &hints, &res) != 0) {
+        return -1;
+    }
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd < 0) {
+        freeaddrinfo(res);
+        return -1;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    if (connect(fd, res->ai_addr, res->ai_addrlen) < 0 &&
+        errno != EINPROGRESS) {
+        close(fd);
+        freeaddrinfo(res);
+        return -1;
+    }
+
+    freeaddrinfo(res);
+    return fd;
+}
+
+int connection_pool_init(connection_pool_t *pool, const char *url,
+                         scan_config_t *config) {
+    memset(pool, 0, sizeof(*pool));
+    pool->config = config;
+
+    if (pool_parse_url(pool, url) != 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < POOL_CONNECTIONS; i++) {
+        pool->conns[i].fd = pool_open_socket(pool->host, pool->port);
+        if (pool->conns[i].fd < 0) {
+            connection_pool_close(pool);
+            return -1;
+        }
+    }
+
+    if (config->verbose) {
+        printf("[INFO] Connection pool: %d sockets to %s:%d, pipeline depth %d\n",
+               POOL_CONNECTIONS, pool->host, pool->port, POOL_PIPELINE_DEPTH);
+    }
+
+    return 0;
+}
+
+static void pool_close_conn(pool_connection_t *conn) {
+    if (conn->fd >= 0) {
+        close(conn->fd);
+    }
+    conn->fd = -1;
+    conn->connected = 0;
+    conn->in_flight = 0;
+    conn->recv_len = 0;
+}
+
+void connection_pool_close(connection_pool_t *pool) {
+    for (int i = 0; i < POOL_CONNECTIONS; i++) {
+        pool_close_conn(&pool->conns[i]);
+    }
+}
+
+// Case-insensitive header lookup within the raw header block
+static const char *pool_find_header(const char *headers, size_t len,
+                                    const char *name) {
+    size_t name_len = strlen(name);
+
+    for (size_t i = 0; i + name_len < len; i++) {
+        if ((i == 0 || headers[i - 1] == '\n') &&
+            strncasecmp(headers + i, name, name_len) == 0) {
+            return headers + i + name_len;
+        }
+    }
+    return NULL;
+}
+
+// Queue one pipelined GET on a connection (requests are small enough
+// that a single send into the socket buffer always succeeds here)
+static int pool_send_request(connection_pool_t *pool, pool_connection_t *conn,
+                             const char *path, int request_index) {
+    char request[POOL_REQUEST_MAX];
+
+    int len = snprintf(request, sizeof(request),
+                       "GET %s HTTP/1.1\r\n"
+                       "Host: %s\r\n"
+                       "User-Agent: %s\r\n"
+                       "Accept: */*\r\n"
+                       "Connection: keep-alive\r\n"
+                       "\r\n",
+                       path, pool->host, pool->config->user_agent);
+    if (len < 0 || len >= (int)sizeof(request)) {
+        return -1;
+    }
+
+    if (send(conn->fd, request, len, MSG_NOSIGNAL) != len) {
+        return -1;
+    }
+
+    conn->pending[conn->in_flight++] = request_index;
+    update_scan_statistics(STAT_REQUESTS_SENT, 1);
+    return 0;
+}
+
+// Try to frame one complete response at the front of the receive
+// buffer. Returns total framed length (headers + body) and fills in
+// the status code, body offset and keep-alive flag; 0 if incomplete.
+static size_t pool_frame_response(pool_connection_t *conn, long *code,
+                                  size_t *body_off, size_t *body_len,
+                                  int *keep_alive) {
+    const char *buf = conn->recv_buf;
+
+    const char *hdr_end = NULL;
+    for (size_t i = 0; i + 3 < conn->recv_len; i++) {
+        if (memcmp(buf + i, "\r\n\r\n", 4) == 0) {
+            hdr_end = buf + i + 4;
+            break;
+        }
+    }
+    if (!hdr_end) {
+        return 0;
+    }
+
+    size_t hdr_len = hdr_end - buf;
+
+    if (conn->recv_len < 12 || strncmp(buf, "HTTP/1.", 7) != 0) {
+        return 0;
+    }
+    *code = atol(buf + 9);
+
+    // HTTP/1.0 closes by default; an explicit "close" does too
+    *keep_alive = (buf[7] == '1');
+    const char *conn_hdr = pool_find_header(buf, hdr_len, "Connection:");
+    if (conn_hdr && strncasecmp(conn_hdr + strspn(conn_hdr, " "), "close", 5) == 0) {
+        *keep_alive = 0;
+    }
+
+    *body_off = hdr_len;
+
+    const char *cl = pool_find_header(buf, hdr_len, "Content-Length:");
+    if (cl) {
+        *body_len = (size_t)atol(cl);
+        if (hdr_len + *body_len > conn->recv_len) {
+            return 0;  // Body not fully buffered yet
+        }
+        return hdr_len + *body_len;
+    }
+
+    const char *te = pool_find_header(buf, hdr_len, "Transfer-Encoding:");
+    if (te && strncasecmp(te + strspn(te, " "), "chunked", 7) == 0) {
+        // Wait for the terminating zero-length chunk; the callback
+        // gets the raw chunked body, which strstr matching tolerates
+        for (size_t i = hdr_len; i + 4 < conn->recv_len; i++) {
+            if (memcmp(buf + i, "0\r\n\r\n", 5) == 0) {
+                *body_len = i + 5 - hdr_len;
+                return hdr_len + *body_len;
+            }
+        }
+        return 0;
+    }
+
+    // No length information: header-only response (e.g. 204/304)
+    *body_len = 0;
+    return hdr_len;
+}
+
+// Drive the batch to completion: top up each connection's pipeline,
+// poll all sockets, frame responses in arrival order. Returns the
+// number of responses delivered to the callback.
+int connection_pool_run_batch(connection_pool_t *pool, char **request_paths,
+                              int count, pool_response_cb callback,
+                              void *user_data) {
+    int *requeue = malloc(count * sizeof(int));
+    int requeue_top = 0;
+    int next_index = 0;
+    int completed = 0;
+
+    if (!requeue) {
+        return -1;
+    }
+
+    while (completed < count && !stop_scanning) {
+        struct pollfd pfds[POOL_CONNECTIONS];
+
+        for (int i = 0; i < POOL_CONNECTIONS; i++) {
+            pool_connection_t *conn = &pool->conns[i];
+
+            // Reconnect closed sockets while work remains
+            if (conn->fd < 0 &&
+                (next_index < count || requeue_top > 0)) {
+                conn->fd = pool_open_socket(pool->host, pool->port);
+            }
+
+            pfds[i].fd = conn->fd;
+            pfds[i].events = conn->connected ? POLLIN : POLLOUT;
+            pfds[i].revents = 0;
+        }
+
+        if (poll(pfds, POOL_CONNECTIONS, pool->config->timeout * 1000) <= 0) {
+            break;  // Target stopped answering; report what we have
+        }
+
+        for (int i = 0; i < POOL_CONNECTIONS; i++) {
+            pool_connection_t *conn = &pool->conns[i];
+
+            if (conn->fd < 0) {
+                continue;
+            }
+
+            if (!conn->connected && (pfds[i].revents & (POLLOUT | POLLERR))) {
+                int err = 0;
+                socklen_t err_len = sizeof(err);
+                getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &err, &err_len);
+                if (err != 0) {
+                    pool_close_conn(conn);
+                    continue;
+                }
+                conn->connected = 1;
+            }
+
+            if (!conn->connected) {
+                continue;
+            }
+
+            // Keep the pipeline full: requeued work first, then fresh
+            while (conn->in_flight < POOL_PIPELINE_DEPTH &&
+                   (requeue_top > 0 || next_index < count)) {
+                int idx = requeue_top > 0 ? requeue[--requeue_top]
+                                          : next_index++;
+                if (pool_send_request(pool, conn, request_paths[idx], idx) != 0) {
+                    requeue[requeue_top++] = idx;
+                    break;
+                }
+            }
+
+            if (!(pfds[i].revents & (POLLIN | POLLHUP))) {
+                continue;
+            }
+
+            ssize_t n = recv(conn->fd, conn->recv_buf + conn->recv_len,
+                             POOL_RECV_BUFFER - conn->recv_len - 1, 0);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    continue;
+                }
+                // Peer closed: responses still in flight get resent
+                for (int p = 0; p < conn->in_flight; p++) {
+                    requeue[requeue_top++] = conn->pending[p];
+                }
+                pool_close_conn(conn);
+                continue;
+            }
+            conn->recv_len += n;
+            conn->recv_buf[conn->recv_len] = '\0';
+
+            // Responses arrive in the order requests were pipelined
+            long code;
+            size_t body_off, body_len, framed;
+            int keep_alive;
+            while (conn->in_flight > 0 &&
+                   (framed = pool_frame_response(conn, &code, &body_off,
+                                                 &body_len, &keep_alive)) > 0) {
+                int idx = conn->pending[0];
+
+                callback(idx, code, conn->recv_buf + body_off, body_len,
+                         user_data);
+                completed++;
+                conn->requests_served++;
+                update_scan_statistics(STAT_RESPONSES_RECEIVED, 1);
+
+                memmove(conn->pending, conn->pending + 1,
+                        (conn->in_flight - 1) * sizeof(int));
+                conn->in_flight--;
+
+                memmove(conn->recv_buf, conn->recv_buf + framed,
+                        conn->recv_len - framed);
+                conn->recv_len -= framed;
+                conn->recv_buf[conn->recv_len] = '\0';
+
+                if (!keep_alive) {
+                    for (int p = 0; p < conn->in_flight; p++) {
+                        requeue[requeue_top++] = conn->pending[p];
+                    }
+                    pool_close_conn(conn);
+                    break;
+                }
+            }
+
+            // A response larger than the buffer can never be framed
+            if (conn->fd >= 0 && conn->recv_len >= POOL_RECV_BUFFER - 1) {
+                update_scan_statistics(STAT_ERRORS_ENCOUNTERED, 1);
+                for (int p = 0; p < conn->in_flight; p++) {
+                    requeue[requeue_top++] = conn->pending[p];
+                }
+                pool_close_conn(conn);
+            }
+        }
+    }
+
+    free(requeue);
+    return completed;
+}
+
+// ==================== Payload Batch Testing ====================
+
+// SQL injection probes paired with the error patterns they provoke
+static const test_payload_t sql_injection_payloads[] = {
+    { "' OR '1'='1",                NULL, "SQL syntax",             SEVERITY_HIGH },
+    { "' OR '1'='1' --",            NULL, "SQL syntax",             SEVERITY_HIGH },
+    { "\" OR \"1\"=\"1",            NULL, "SQL syntax",             SEVERITY_HIGH },
+    { "' UNION SELECT NULL--",      NULL, "UNION",                  SEVERITY_HIGH },
+    { "'; DROP TABLE users--",      NULL, "SQL syntax",             SEVERITY_CRITICAL },
+    { "1' AND SLEEP(0)--",          NULL, "SQL syntax",             SEVERITY_HIGH },
+    { "' OR 1=1#",                  NULL, "mysql_fetch",            SEVERITY_HIGH },
+    { "admin'--",                   NULL, "ORA-01756",              SEVERITY_HIGH },
+    { "1 AND 1=CONVERT(int,'a')",   NULL, "Conversion failed",      SEVERITY_HIGH },
+    { "' AND extractvalue(1,'~')--", NULL, "XPATH syntax error",    SEVERITY_HIGH },
+};
+
+// XSS probes; detection looks for the payload reflected unencoded
+static const test_payload_t xss_payloads[] = {
+    { "<script>alert(31337)</script>",        "<script>alert(31337)</script>", NULL, SEVERITY_HIGH },
+    { "<img src=x onerror=alert(31337)>",     "onerror=alert(31337)",          NULL, SEVERITY_HIGH },
+    { "\"><svg onload=alert(31337)>",         "<svg onload=alert(31337)>",     NULL, SEVERITY_HIGH },
+    { "javascript:alert(31337)",              "javascript:alert(31337)",       NULL, SEVERITY_MEDIUM },
+    { "'-alert(31337)-'",                     "'-alert(31337)-'",              NULL, SEVERITY_MEDIUM },
+    { "<body onload=alert(31337)>",           "<body onload=alert(31337)>",    NULL, SEVERITY_HIGH },
+};
+
+test_payload_t* get_sql_injection_payloads(int *count) {
+    *count = sizeof(sql_injection_payloads) / sizeof(sql_injection_payloads[0]);
+    test_payload_t *payloads = calloc(*count, sizeof(test_payload_t));
+    if (payloads) {
+        memcpy(payloads, sql_injection_payloads, *count * sizeof(test_payload_t));
+    }
+    return payloads;
+}
+
+test_payload_t* get_xss_payloads(int *count) {
+    *count = sizeof(xss_payloads) / sizeof(xss_payloads[0]);
+    test_payload_t *payloads = calloc(*count, sizeof(test_payload_t));
+    if (payloads) {
+        memcpy(payloads, xss_payloads, *count * sizeof(test_payload_t));
+    }
+    return payloads;
+}
+
+void free_test_payloads(test_payload_t *payloads, int count) {
+    (void)count;  // Entries reference static tables
+    free(payloads);
+}
+
+// Percent-encode a payload for use in a query string
+static void pool_url_encode(const char *src, char *dst, size_t dst_size) {
+    static const char hex[] = "0123456789ABCDEF";
+    size_t out = 0;
+
+    for (; *src && out + 4 < dst_size; src++) {
+        unsigned char c = (unsigned char)*src;
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.') {
+            dst[out++] = c;
+        } else {
+            dst[out++] = '%';
+            dst[out++] = hex[c >> 4];
+            dst[out++] = hex[c & 0xF];
+        }
+    }
+    dst[out] = '\0';
+}
+
+typedef struct {
+    test_payload_t *payloads;
+    vulnerability_type_t type;
+    const char *parameter;
+    const char *base_url;
+    int hits;
+} payload_batch_ctx_t;
+
+// One response per payload: check for provoked errors or reflection
+static void payload_batch_callback(int request_index, long response_code,
+                                   const char *body, size_t body_len,
+                                   void *user_data) {
+    payload_batch_ctx_t *ctx = user_data;
+    test_payload_t *payload = &ctx->payloads[request_index];
+    const char *evidence = NULL;
+
+    (void)body_len;  // recv buffer is NUL-terminated
+
+    if (response_code >= 500) {
+        return;  // Server fell over; not evidence by itself
+    }
+
+    if (payload->error_pattern && strstr(body, payload->error_pattern)) {
+        evidence = payload->error_pattern;
+    } else if (payload->expected_response &&
+               strstr(body, payload->expected_response)) {
+        evidence = payload->expected_response;
+    }
+
+    if (evidence) {
+        printf("[VULN] %s in parameter '%s' at %s (payload: %s)\n",
+               vulnerability_type_to_string(ctx->type), ctx->parameter,
+               ctx->base_url, payload->payload);
+        ctx->hits++;
+        update_scan_statistics(STAT_VULNERABILITIES_FOUND, 1);
+    }
+}
+
+// Run a whole payload list against one parameter over the pool.
+// Returns the number of suspicious responses, or -1 if the pool
+// could not be established (caller falls back to per-request curl).
+int test_payload_batch(const char *base_url, const char *parameter,
+                       test_payload_t *payloads, int payload_count,
+                       vulnerability_type_t type, scan_config_t *config) {
+    connection_pool_t pool;
+
+    if (connection_pool_init(&pool, base_url, config) != 0) {
+        return -1;
+    }
+
+    char **paths = calloc(payload_count, sizeof(char *));
+    if (!paths) {
+        connection_pool_close(&pool);
+        return -1;
+    }
+
+    char encoded[MAX_PARAMETER_LENGTH * 3];
+    for (int i = 0; i < payload_count; i++) {
+        pool_url_encode(payloads[i].payload, encoded, sizeof(encoded));
+        size_t path_size = strlen(pool.base_path) + strlen(parameter) +
+                           strlen(encoded) + 3;
+        paths[i] = malloc(path_size);
+        if (!paths[i]) {
+            payload_count = i;
+            break;
+        }
+        snprintf(paths[i], path_size, "%s?%s=%s",
+                 pool.base_path, parameter, encoded);
+    }
+
+    payload_batch_ctx_t ctx = {
+        .payloads = payloads,
+        .type = type,
+        .parameter = parameter,
+        .base_url = base_url,
+        .hits = 0
+    };
+
+    int completed = connection_pool_run_batch(&pool, paths, payload_count,
+                                              payload_batch_callback, &ctx);
+
+    if (config->verbose) {
+        printf("[INFO] Batch complete: %d/%d responses over %d connections\n",
+               completed, payload_count, POOL_CONNECTIONS);
+    }
+
+    for (int i = 0; i < payload_count; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    connection_pool_close(&pool);
+
+    return ctx.hits;
+}
+
 // Generate report based on configuration
 int generate_report(scan_config_t *config, scan_result_t *results, int result_count) {
     FILE *output_fp = stdout;
@@ -175,6 +175,38 @@ typedef struct {
     size_t headers_size;
 } http_response_t;
 
+// Keep-alive connection pool: a few persistent non-blocking sockets
+// per target host with HTTP/1.1 request pipelining, so a payload batch
+// pays for a handful of TCP handshakes instead of one per request
+#define POOL_CONNECTIONS 4
+#define POOL_PIPELINE_DEPTH 16
+#define POOL_REQUEST_MAX 4096
+#define POOL_RECV_BUFFER 65536
+#define POOL_HOST_LENGTH 256
+
+typedef struct {
+    int fd;
+    int connected;                  // Non-blocking connect completed
+    int in_flight;                  // Pipelined requests awaiting response
+    int pending[POOL_PIPELINE_DEPTH]; // Batch indices, FIFO response order
+    char recv_buf[POOL_RECV_BUFFER];
+    size_t recv_len;
+    int requests_served;            // Over the connection lifetime
+} pool_connection_t;
+
+typedef struct {
+    pool_connection_t conns[POOL_CONNECTIONS];
+    char host[POOL_HOST_LENGTH];
+    int port;
+    char base_path[MAX_URL_LENGTH];
+    scan_config_t *config;
+} connection_pool_t;
+
+// Invoked once per completed pipelined response, in arrival order
+typedef void (*pool_response_cb)(int request_index, long response_code,
+                                 const char *body, size_t body_len,
+                                 void *user_data);
+
 // Function prototypes
 
 // Main functions
@@ -211,6 +243,15 @@ int test_security_headers(vulnerability_context_t *ctx, crawler_context_t *crawl
 int test_authentication_bypass(vulnerability_context_t *ctx, crawler_context_t *crawler_ctx);
 int test_session_management(vulnerability_context_t *ctx, crawler_context_t *crawler_ctx);
 
+// Connection pool functions
+int connection_pool_init(connection_pool_t *pool, const char *url, scan_config_t *config);
+void connection_pool_close(connection_pool_t *pool);
+int connection_pool_run_batch(connection_pool_t *pool, char **request_paths, int count,
+                              pool_response_cb callback, void *user_data);
+int test_payload_batch(const char *base_url, const char *parameter,
+                       test_payload_t *payloads, int payload_count,
+                       vulnerability_type_t type, scan_config_t *config);
+
 // HTTP functions
 http_response_t* http_get(const char *url, scan_config_t *config);
 http_response_t* http_post(const char *url, const char *data, scan_config_t *config);